@@ -0,0 +1,174 @@
+/* Copyright 2026 NXP
+ *
+ * SPDX-License-Identifier:        BSD-3-Clause
+ */
+
+#include "compat.h"
+#include <fsl_qbman_demux.h>
+#include "qbman_portal.h"
+
+/* Flow slots are cacheline sized and aligned, which leaves the low 6 bits of
+ * their address free for the generation tag.
+ */
+#define QBMAN_DEMUX_ALIGN	64
+#define QBMAN_DEMUX_TAG_MASK	((uint64_t)QBMAN_DEMUX_ALIGN - 1)
+
+struct qbman_demux_flow {
+	qbman_demux_handler handler; /* NULL if the slot is free */
+	void *ctx;
+	uint32_t tag;
+	uint32_t next_free;
+} __attribute__((aligned(QBMAN_DEMUX_ALIGN)));
+
+struct qbman_demux {
+	struct qbman_demux_flow *flows;
+	uint32_t size;
+	uint32_t free_head; /* 'size' if no slot is free */
+};
+
+struct qbman_demux *qbman_demux_create(uint32_t max_flows)
+{
+	struct qbman_demux *dm;
+	uint32_t i;
+
+	if (!max_flows)
+		return NULL;
+
+	dm = malloc(sizeof(*dm));
+	if (!dm)
+		return NULL;
+
+	if (posix_memalign((void **)&dm->flows, QBMAN_DEMUX_ALIGN,
+			   max_flows * sizeof(*dm->flows))) {
+		pr_err("qbman_demux: no memory for %u flows\n", max_flows);
+		free(dm);
+		return NULL;
+	}
+	memset(dm->flows, 0, max_flows * sizeof(*dm->flows));
+	for (i = 0; i < max_flows; i++)
+		dm->flows[i].next_free = i + 1;
+	dm->size = max_flows;
+	dm->free_head = 0;
+	return dm;
+}
+
+void qbman_demux_destroy(struct qbman_demux *dm)
+{
+	if (!dm)
+		return;
+	free(dm->flows);
+	free(dm);
+}
+
+static inline struct qbman_demux_flow *qbman_demux_lookup(
+			const struct qbman_demux *dm, uint64_t fqd_ctx)
+{
+	struct qbman_demux_flow *f;
+	uint64_t off;
+
+	off = (fqd_ctx & ~QBMAN_DEMUX_TAG_MASK) -
+		(uint64_t)(uintptr_t)dm->flows;
+	if (off >= (uint64_t)dm->size * sizeof(*f))
+		return NULL;
+
+	f = &dm->flows[off / sizeof(*f)];
+	if (!f->handler || f->tag != (fqd_ctx & QBMAN_DEMUX_TAG_MASK))
+		return NULL;
+	return f;
+}
+
+int qbman_demux_register(struct qbman_demux *dm, qbman_demux_handler handler,
+			 void *ctx, uint64_t *fqd_ctx)
+{
+	struct qbman_demux_flow *f;
+
+	if (!handler)
+		return -EINVAL;
+	if (dm->free_head == dm->size)
+		return -ENOSPC;
+
+	f = &dm->flows[dm->free_head];
+	dm->free_head = f->next_free;
+	/* A new tag per registration, so FQs still carrying the context of a
+	 * previous user of the slot don't reach the new handler.
+	 */
+	f->tag = (f->tag + 1) & QBMAN_DEMUX_TAG_MASK;
+	f->ctx = ctx;
+	f->handler = handler;
+	*fqd_ctx = (uint64_t)(uintptr_t)f | f->tag;
+	return 0;
+}
+
+int qbman_demux_unregister(struct qbman_demux *dm, uint64_t fqd_ctx)
+{
+	struct qbman_demux_flow *f = qbman_demux_lookup(dm, fqd_ctx);
+
+	if (!f)
+		return -EINVAL;
+
+	f->handler = NULL;
+	f->ctx = NULL;
+	f->next_free = dm->free_head;
+	dm->free_head = f - dm->flows;
+	return 0;
+}
+
+static int qbman_demux_burst_one(const struct qbman_demux *dm,
+				 struct qbman_swp *s,
+				 const struct qbman_result **dq, int num,
+				 qbman_demux_handler miss, void *miss_ctx)
+{
+	const struct qbman_demux_flow *flow[QBMAN_DEMUX_BURST_MAX];
+	const struct qbman_result *vec[QBMAN_DEMUX_BURST_MAX];
+	const struct qbman_demux_flow *f;
+	int i, j, n, nmiss = 0, done = 0;
+
+	/* First pass: resolve every result to its flow */
+	for (i = 0; i < num; i++) {
+		if (qbman_result_is_DQ(dq[i]))
+			flow[i] = qbman_demux_lookup(dm,
+					qbman_result_DQ_fqd_ctx(dq[i]));
+		else
+			flow[i] = NULL;
+		if (!flow[i])
+			vec[nmiss++] = dq[i];
+	}
+	if (nmiss && miss)
+		miss(miss_ctx, s, vec, nmiss);
+	if (nmiss == num)
+		return 0;
+
+	/* Second pass: gather each flow's results and hand them over at once,
+	 * clearing the slots as they are delivered.
+	 */
+	for (i = 0; i < num; i++) {
+		f = flow[i];
+		if (!f)
+			continue;
+		n = 0;
+		for (j = i; j < num; j++) {
+			if (flow[j] == f) {
+				vec[n++] = dq[j];
+				flow[j] = NULL;
+			}
+		}
+		f->handler(f->ctx, s, vec, n);
+		done += n;
+	}
+	return done;
+}
+
+int qbman_demux_burst(const struct qbman_demux *dm, struct qbman_swp *s,
+		      const struct qbman_result **dq, int num,
+		      qbman_demux_handler miss, void *miss_ctx)
+{
+	int n, done = 0;
+
+	while (num > 0) {
+		n = num > QBMAN_DEMUX_BURST_MAX ? QBMAN_DEMUX_BURST_MAX : num;
+		done += qbman_demux_burst_one(dm, s, dq, n, miss, miss_ctx);
+		dq += n;
+		num -= n;
+	}
+	return done;
+}
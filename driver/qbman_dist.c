@@ -0,0 +1,315 @@
+/* Copyright 2026 NXP
+ *
+ * SPDX-License-Identifier:        BSD-3-Clause
+ */
+
+#include "compat.h"
+#include <fsl_qbman_dist.h>
+#include "qbman_portal.h"
+
+#include <pthread.h>
+
+#if defined(__aarch64__) && defined(__linux__)
+#include <sys/auxv.h>
+#define QBMAN_CRC32C_HW
+#ifndef HWCAP_CRC32
+#define HWCAP_CRC32 (1 << 7)
+#endif
+#endif
+
+#define QBMAN_DIST_BURST_MAX 32
+
+struct qbman_dist {
+	uint32_t mask;
+	uint32_t seed;
+	int qd; /* entries are bins of 'qdid' rather than FQIDs */
+	uint32_t qdid;
+	uint8_t qd_prio;
+	volatile uint32_t *table;
+};
+
+/********/
+/* Hash */
+/********/
+
+/* CRC32C is computed with the ARMv8 CRC32 instructions whenever the CPU has
+ * them, whatever the build targets: that implementation is compiled for +crc
+ * on its own and picked at run time from the hwcaps. Other CPUs use a
+ * slice-by-8 table, which also takes 8 bytes per step.
+ */
+#define QBMAN_CRC32C_POLY 0x82f63b78
+
+static uint32_t qbman_crc32c_table[8][256];
+static int qbman_crc32c_has_hw;
+static pthread_once_t qbman_crc32c_once = PTHREAD_ONCE_INIT;
+
+static void qbman_crc32c_init(void)
+{
+	uint32_t crc;
+	int i, j;
+
+#ifdef QBMAN_CRC32C_HW
+	qbman_crc32c_has_hw = !!(getauxval(AT_HWCAP) & HWCAP_CRC32);
+	if (qbman_crc32c_has_hw)
+		return;
+#endif
+	for (i = 0; i < 256; i++) {
+		crc = i;
+		for (j = 0; j < 8; j++)
+			crc = (crc >> 1) ^ (QBMAN_CRC32C_POLY & -(crc & 1));
+		qbman_crc32c_table[0][i] = crc;
+	}
+	for (j = 1; j < 8; j++)
+		for (i = 0; i < 256; i++) {
+			crc = qbman_crc32c_table[j - 1][i];
+			qbman_crc32c_table[j][i] = (crc >> 8) ^
+				qbman_crc32c_table[0][crc & 0xff];
+		}
+}
+
+static inline uint32_t qbman_crc32c_sw_u8(uint32_t crc, uint8_t v)
+{
+	return (crc >> 8) ^ qbman_crc32c_table[0][(crc ^ v) & 0xff];
+}
+
+/* The 8 bytes are taken least significant first, as by the instructions */
+static inline uint32_t qbman_crc32c_sw_u64(uint32_t crc, uint64_t v)
+{
+	v ^= crc;
+	return qbman_crc32c_table[7][v & 0xff] ^
+		qbman_crc32c_table[6][(v >> 8) & 0xff] ^
+		qbman_crc32c_table[5][(v >> 16) & 0xff] ^
+		qbman_crc32c_table[4][(v >> 24) & 0xff] ^
+		qbman_crc32c_table[3][(v >> 32) & 0xff] ^
+		qbman_crc32c_table[2][(v >> 40) & 0xff] ^
+		qbman_crc32c_table[1][(v >> 48) & 0xff] ^
+		qbman_crc32c_table[0][v >> 56];
+}
+
+#ifdef QBMAN_CRC32C_HW
+
+static inline __attribute__((target("+crc")))
+uint32_t qbman_crc32c_hw_u64(uint32_t crc, uint64_t v)
+{
+	asm("crc32cx %w0, %w0, %x1" : "+r" (crc) : "r" (v));
+	return crc;
+}
+
+static inline __attribute__((target("+crc")))
+uint32_t qbman_crc32c_hw_u8(uint32_t crc, uint8_t v)
+{
+	asm("crc32cb %w0, %w0, %w1" : "+r" (crc) : "r" ((uint32_t)v));
+	return crc;
+}
+
+#endif
+
+typedef uint32_t (*qbman_crc32c_u64_fn)(uint32_t crc, uint64_t v);
+typedef uint32_t (*qbman_crc32c_u8_fn)(uint32_t crc, uint8_t v);
+
+/* The hashing loops, inlined into each implementation with its steps */
+static inline __attribute__((always_inline))
+uint32_t qbman_crc32c(const uint8_t *p, uint32_t len, uint32_t crc,
+		      qbman_crc32c_u64_fn u64, qbman_crc32c_u8_fn u8)
+{
+	uint64_t v;
+
+	for (; len >= 8; len -= 8, p += 8) {
+		memcpy(&v, p, sizeof(v));
+		crc = u64(crc, v);
+	}
+	for (; len; len--, p++)
+		crc = u8(crc, *p);
+	return crc;
+}
+
+/* Four keys at a time, so the independent CRC chains overlap in the pipeline
+ * instead of each waiting on the latency of the previous step.
+ */
+static inline __attribute__((always_inline))
+void qbman_crc32c_burst(const void * const *keys, uint32_t len,
+			uint32_t seed, uint32_t *hash, int num,
+			qbman_crc32c_u64_fn u64, qbman_crc32c_u8_fn u8)
+{
+	const uint8_t *p0, *p1, *p2, *p3;
+	uint32_t c0, c1, c2, c3, off;
+	uint64_t v0, v1, v2, v3;
+	int i;
+
+	for (i = 0; i + 4 <= num; i += 4) {
+		p0 = keys[i];
+		p1 = keys[i + 1];
+		p2 = keys[i + 2];
+		p3 = keys[i + 3];
+		c0 = c1 = c2 = c3 = seed;
+		for (off = 0; off + 8 <= len; off += 8) {
+			memcpy(&v0, p0 + off, sizeof(v0));
+			memcpy(&v1, p1 + off, sizeof(v1));
+			memcpy(&v2, p2 + off, sizeof(v2));
+			memcpy(&v3, p3 + off, sizeof(v3));
+			c0 = u64(c0, v0);
+			c1 = u64(c1, v1);
+			c2 = u64(c2, v2);
+			c3 = u64(c3, v3);
+		}
+		for (; off < len; off++) {
+			c0 = u8(c0, p0[off]);
+			c1 = u8(c1, p1[off]);
+			c2 = u8(c2, p2[off]);
+			c3 = u8(c3, p3[off]);
+		}
+		hash[i] = c0;
+		hash[i + 1] = c1;
+		hash[i + 2] = c2;
+		hash[i + 3] = c3;
+	}
+	for (; i < num; i++)
+		hash[i] = qbman_crc32c(keys[i], len, seed, u64, u8);
+}
+
+#ifdef QBMAN_CRC32C_HW
+
+static __attribute__((target("+crc")))
+uint32_t qbman_crc32c_hw(const void *key, uint32_t len, uint32_t seed)
+{
+	return qbman_crc32c(key, len, seed, qbman_crc32c_hw_u64,
+			    qbman_crc32c_hw_u8);
+}
+
+static __attribute__((target("+crc")))
+void qbman_crc32c_hw_burst(const void * const *keys, uint32_t len,
+			   uint32_t seed, uint32_t *hash, int num)
+{
+	qbman_crc32c_burst(keys, len, seed, hash, num, qbman_crc32c_hw_u64,
+			   qbman_crc32c_hw_u8);
+}
+
+#endif
+
+uint32_t qbman_dist_hash(const void *key, uint32_t len, uint32_t seed)
+{
+	pthread_once(&qbman_crc32c_once, qbman_crc32c_init);
+#ifdef QBMAN_CRC32C_HW
+	if (qbman_crc32c_has_hw)
+		return qbman_crc32c_hw(key, len, seed);
+#endif
+	return qbman_crc32c(key, len, seed, qbman_crc32c_sw_u64,
+			    qbman_crc32c_sw_u8);
+}
+
+void qbman_dist_hash_burst(const void * const *keys, uint32_t len,
+			   uint32_t seed, uint32_t *hash, int num)
+{
+	pthread_once(&qbman_crc32c_once, qbman_crc32c_init);
+#ifdef QBMAN_CRC32C_HW
+	if (qbman_crc32c_has_hw) {
+		qbman_crc32c_hw_burst(keys, len, seed, hash, num);
+		return;
+	}
+#endif
+	qbman_crc32c_burst(keys, len, seed, hash, num, qbman_crc32c_sw_u64,
+			   qbman_crc32c_sw_u8);
+}
+
+/*********************/
+/* Indirection table */
+/*********************/
+
+struct qbman_dist *qbman_dist_create(uint32_t table_size, uint32_t seed)
+{
+	struct qbman_dist *dist;
+	uint32_t *table;
+
+	if (!table_size || (table_size & (table_size - 1))) {
+		pr_err("qbman_dist: table size %u not a power of 2\n",
+		       table_size);
+		return NULL;
+	}
+
+	dist = malloc(sizeof(*dist));
+	if (!dist)
+		return NULL;
+
+	table = calloc(table_size, sizeof(*table));
+	if (!table) {
+		free(dist);
+		return NULL;
+	}
+	dist->mask = table_size - 1;
+	dist->seed = seed;
+	dist->qd = 0;
+	dist->qdid = 0;
+	dist->qd_prio = 0;
+	dist->table = table;
+	return dist;
+}
+
+void qbman_dist_destroy(struct qbman_dist *dist)
+{
+	if (!dist)
+		return;
+	free((void *)(uintptr_t)dist->table);
+	free(dist);
+}
+
+void qbman_dist_set_qd(struct qbman_dist *dist, uint32_t qdid,
+		       uint8_t qd_prio)
+{
+	dist->qd = 1;
+	dist->qdid = qdid;
+	dist->qd_prio = qd_prio;
+}
+
+int qbman_dist_set_entry(struct qbman_dist *dist, uint32_t idx,
+			 uint32_t target)
+{
+	if (idx > dist->mask)
+		return -EINVAL;
+
+	dist->table[idx] = target;
+	return 0;
+}
+
+int qbman_dist_fill(struct qbman_dist *dist, const uint32_t *targets,
+		    uint32_t num)
+{
+	uint32_t i;
+
+	if (!num)
+		return -EINVAL;
+
+	for (i = 0; i <= dist->mask; i++)
+		dist->table[i] = targets[i % num];
+	return 0;
+}
+
+uint32_t qbman_dist_lookup(const struct qbman_dist *dist, uint32_t hash)
+{
+	return dist->table[hash & dist->mask];
+}
+
+void qbman_dist_desc_burst(const struct qbman_dist *dist,
+			   const struct qbman_eq_desc *tmpl,
+			   const void * const *keys, uint32_t key_len,
+			   struct qbman_eq_desc *d, int num)
+{
+	uint32_t hash[QBMAN_DIST_BURST_MAX];
+	uint32_t target;
+	int i, j, n;
+
+	for (i = 0; i < num; i += n) {
+		n = num - i;
+		if (n > QBMAN_DIST_BURST_MAX)
+			n = QBMAN_DIST_BURST_MAX;
+		qbman_dist_hash_burst(&keys[i], key_len, dist->seed, hash, n);
+		for (j = 0; j < n; j++) {
+			target = dist->table[hash[j] & dist->mask];
+			d[i + j] = *tmpl;
+			if (dist->qd)
+				qbman_eq_desc_set_qd(&d[i + j], dist->qdid,
+						     target, dist->qd_prio);
+			else
+				qbman_eq_desc_set_fq(&d[i + j], target);
+		}
+	}
+}
@@ -0,0 +1,199 @@
+/* Copyright 2026 NXP
+ *
+ * SPDX-License-Identifier:        BSD-3-Clause
+ */
+
+#include "compat.h"
+#include <fsl_qbman_ern.h>
+#include "qbman_portal.h"
+
+#define QBMAN_ERN_TOKEN		1
+#define QBMAN_ERN_POOLS		4
+
+/* Buffers waiting to be released to one pool */
+struct qbman_ern_rel {
+	uint16_t bpid;
+	uint8_t num;
+	uint64_t bufs[7];
+};
+
+struct qbman_ern {
+	struct qbman_result *ring;
+	uint64_t ring_iova;
+	uint32_t mask;
+	uint32_t pi; /* next slot handed out */
+	uint32_t ci; /* next slot to harvest */
+	qbman_ern_cb cb;
+	void *ctx;
+	struct qbman_ern_rel rel[QBMAN_ERN_POOLS];
+	struct qbman_ern_stats stats;
+};
+
+struct qbman_ern *qbman_ern_create(struct qbman_result *ring,
+				   uint64_t ring_iova, uint32_t size,
+				   qbman_ern_cb cb, void *ctx)
+{
+	struct qbman_ern *e;
+
+	if (!ring || !size || (size & (size - 1))) {
+		pr_err("qbman_ern: bad response ring\n");
+		return NULL;
+	}
+
+	e = malloc(sizeof(*e));
+	if (!e)
+		return NULL;
+
+	memset(e, 0, sizeof(*e));
+	memset(ring, 0, size * sizeof(*ring));
+	e->ring = ring;
+	e->ring_iova = ring_iova;
+	e->mask = size - 1;
+	e->cb = cb;
+	e->ctx = ctx;
+	return e;
+}
+
+void qbman_ern_destroy(struct qbman_ern *e)
+{
+	free(e);
+}
+
+int qbman_ern_desc_set(struct qbman_ern *e, struct qbman_eq_desc *d)
+{
+	uint32_t idx;
+
+	if (e->pi - e->ci > e->mask)
+		return -EBUSY;
+
+	idx = e->pi++ & e->mask;
+	/* Slots are recycled in order, so every enqueue has to write one */
+	qbman_eq_desc_set_response_always(d);
+	qbman_eq_desc_set_response(d, e->ring_iova + idx * sizeof(*e->ring), 1);
+	qbman_eq_desc_set_token(d, QBMAN_ERN_TOKEN);
+	return 0;
+}
+
+static int qbman_ern_rel_flush(struct qbman_ern *e, struct qbman_swp *s,
+			       struct qbman_ern_rel *r)
+{
+	if (!r->num)
+		return 0;
+
+	if (qbman_swp_release_bpid(s, r->bpid, r->bufs, r->num))
+		return -EBUSY;
+
+	e->stats.released += r->num;
+	r->num = 0;
+	return 0;
+}
+
+/* Queue a buffer for release, flushing full batches. Returns -EBUSY, with the
+ * buffer not queued, if no batch can take it because the RCR is busy.
+ */
+static int qbman_ern_rel_add(struct qbman_ern *e, struct qbman_swp *s,
+			     uint16_t bpid, uint64_t buf)
+{
+	struct qbman_ern_rel *r, *free_rel = NULL;
+	int i;
+
+	for (i = 0; i < QBMAN_ERN_POOLS; i++) {
+		r = &e->rel[i];
+		if (r->num && r->bpid == bpid)
+			break;
+		if (!r->num && !free_rel)
+			free_rel = r;
+	}
+	if (i == QBMAN_ERN_POOLS) {
+		r = free_rel;
+		if (!r) {
+			/* Make room by flushing the fullest batch */
+			r = &e->rel[0];
+			for (i = 1; i < QBMAN_ERN_POOLS; i++)
+				if (e->rel[i].num > r->num)
+					r = &e->rel[i];
+			if (qbman_ern_rel_flush(e, s, r))
+				return -EBUSY;
+		}
+		r->bpid = bpid;
+	} else if (r->num == 7 && qbman_ern_rel_flush(e, s, r)) {
+		return -EBUSY;
+	}
+
+	r->bufs[r->num++] = buf;
+	if (r->num == 7)
+		qbman_ern_rel_flush(e, s, r);
+	return 0;
+}
+
+/* Return the buffer of a rejected frame. Returns -EBUSY if it has to wait */
+static int qbman_ern_reject(struct qbman_ern *e, struct qbman_swp *s,
+			    const struct qbman_result *rsp)
+{
+	const struct qbman_fd *fd = qbman_result_eqresp_fd(rsp);
+
+	if (!qbman_fd_is_simple(fd)) {
+		e->stats.unreleased++;
+		return 0;
+	}
+
+	return qbman_ern_rel_add(e, s, qbman_fd_get_bpid(fd),
+				 qbman_fd_get_addr(fd));
+}
+
+int qbman_ern_poll(struct qbman_ern *e, struct qbman_swp *s, int budget)
+{
+	struct qbman_result *rsp;
+	uint8_t rc;
+	int i, num = 0;
+
+	while (num < budget && e->ci != e->pi) {
+		rsp = &e->ring[e->ci & e->mask];
+		if (!qbman_result_eqresp_rspid(rsp))
+			break;
+		smp_rmb();
+
+		rc = qbman_result_eqresp_rc(rsp);
+		if (!rc) {
+			e->stats.enqueued++;
+		} else {
+			/* A rejection whose buffer has to wait for the RCR
+			 * stays in its slot, re-tokened so that the callback
+			 * doesn't see it twice.
+			 */
+			if (qbman_result_eqresp_rspid(rsp) == QBMAN_ERN_TOKEN &&
+			    e->cb && e->cb(e->ctx, rc, rsp)) {
+				e->stats.rejected++;
+				goto next;
+			}
+			if (qbman_ern_reject(e, s, rsp)) {
+				qbman_result_eqresp_set_rspid(rsp,
+						QBMAN_ERN_TOKEN + 1);
+				break;
+			}
+			e->stats.rejected++;
+		}
+next:
+		qbman_result_eqresp_set_rspid(rsp, 0);
+		e->ci++;
+		num++;
+	}
+
+	/* Partial batches go now, anything the RCR refuses is retried on the
+	 * next poll.
+	 */
+	for (i = 0; i < QBMAN_ERN_POOLS; i++)
+		qbman_ern_rel_flush(e, s, &e->rel[i]);
+	return num;
+}
+
+uint32_t qbman_ern_pending(const struct qbman_ern *e)
+{
+	return e->pi - e->ci;
+}
+
+void qbman_ern_stats_get(const struct qbman_ern *e,
+			 struct qbman_ern_stats *st)
+{
+	*st = e->stats;
+}
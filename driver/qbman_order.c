@@ -0,0 +1,213 @@
+/* Copyright 2026 NXP
+ *
+ * SPDX-License-Identifier:        BSD-3-Clause
+ */
+
+#include "compat.h"
+#include <fsl_qbman_order.h>
+#include "qbman_portal.h"
+
+/*********************/
+/* Order restoration */
+/*********************/
+
+struct qbman_orp_ctx {
+	struct qbman_swp *swp;
+	uint32_t size;
+	uint32_t num;
+	struct qbman_eq_desc *desc;
+	struct qbman_fd *fd; /* ignored by hardware for hole and NESN commands */
+};
+
+void qbman_orp_seq_get(const struct qbman_result *dq,
+		       struct qbman_orp_seq *seq)
+{
+	seq->valid = !!(qbman_result_DQ_flags(dq) & QBMAN_DQ_STAT_ODPVALID);
+	seq->odpid = qbman_result_DQ_odpid(dq);
+	seq->seqnum = qbman_result_DQ_seqnum(dq);
+}
+
+void qbman_orp_desc_set(struct qbman_eq_desc *d,
+			const struct qbman_orp_seq *seq,
+			int respond_success, int incomplete)
+{
+	/* The baseline setters only OR in the EC option, so a template that
+	 * already has one would end up with a reserved encoding
+	 */
+	d->eq.verb &= ~(QB_ENQUEUE_CMD_EC_OPTION_MASK |
+			1 << QB_ENQUEUE_CMD_ORP_ENABLE_SHIFT);
+	if (seq->valid)
+		qbman_eq_desc_set_orp(d, respond_success, seq->odpid,
+				      seq->seqnum, incomplete);
+	else
+		qbman_eq_desc_set_no_orp(d, respond_success);
+}
+
+void qbman_orp_desc_burst(const struct qbman_eq_desc *tmpl,
+			  const struct qbman_orp_seq *seq,
+			  struct qbman_eq_desc *d, int num,
+			  int respond_success)
+{
+	int i;
+
+	for (i = 0; i < num; i++) {
+		d[i] = *tmpl;
+		qbman_orp_desc_set(&d[i], &seq[i], respond_success, 0);
+	}
+}
+
+struct qbman_orp_ctx *qbman_orp_ctx_create(struct qbman_swp *s,
+					   uint32_t max_pending)
+{
+	struct qbman_orp_ctx *oc;
+
+	if (!max_pending)
+		return NULL;
+
+	oc = malloc(sizeof(*oc));
+	if (!oc)
+		return NULL;
+
+	oc->desc = malloc(max_pending * sizeof(*oc->desc));
+	oc->fd = calloc(max_pending, sizeof(*oc->fd));
+	if (!oc->desc || !oc->fd) {
+		pr_err("qbman_orp_ctx: no memory for %u commands\n",
+		       max_pending);
+		free(oc->desc);
+		free(oc->fd);
+		free(oc);
+		return NULL;
+	}
+	oc->swp = s;
+	oc->size = max_pending;
+	oc->num = 0;
+	return oc;
+}
+
+void qbman_orp_ctx_destroy(struct qbman_orp_ctx *oc)
+{
+	if (!oc)
+		return;
+	free(oc->desc);
+	free(oc->fd);
+	free(oc);
+}
+
+int qbman_orp_flush(struct qbman_orp_ctx *oc)
+{
+	int ret;
+
+	if (!oc->num)
+		return 0;
+
+	ret = qbman_swp_enqueue_multiple_desc(oc->swp, oc->desc, oc->fd,
+					      oc->num);
+	if (ret <= 0)
+		return oc->num;
+
+	oc->num -= ret;
+	if (oc->num)
+		memmove(oc->desc, &oc->desc[ret], oc->num * sizeof(*oc->desc));
+	return oc->num;
+}
+
+/* Next free command slot, flushing the context if it is full */
+static struct qbman_eq_desc *qbman_orp_slot(struct qbman_orp_ctx *oc)
+{
+	if (oc->num == oc->size && qbman_orp_flush(oc) == (int)oc->size)
+		return NULL;
+
+	return &oc->desc[oc->num++];
+}
+
+int qbman_orp_drop(struct qbman_orp_ctx *oc, const struct qbman_orp_seq *seq)
+{
+	struct qbman_eq_desc *d;
+
+	if (!seq->valid)
+		return 0;
+
+	d = qbman_orp_slot(oc);
+	if (!d)
+		return -EBUSY;
+
+	qbman_eq_desc_clear(d);
+	qbman_eq_desc_set_orp_hole(d, seq->odpid, seq->seqnum);
+	return 0;
+}
+
+int qbman_orp_nesn(struct qbman_orp_ctx *oc, uint16_t odpid, uint16_t seqnum)
+{
+	struct qbman_eq_desc *d;
+
+	d = qbman_orp_slot(oc);
+	if (!d)
+		return -EBUSY;
+
+	qbman_eq_desc_clear(d);
+	qbman_eq_desc_set_orp_nesn(d, odpid, seqnum);
+	return 0;
+}
+
+/**************************/
+/* Held-active completion */
+/**************************/
+
+void qbman_hold_tracker_init(struct qbman_hold_tracker *t)
+{
+	t->pending = 0;
+	t->held = 0;
+}
+
+int qbman_hold_track(struct qbman_hold_tracker *t,
+		     const struct qbman_result *dq)
+{
+	uint16_t bit = 1 << qbman_get_dqrr_idx(dq);
+
+	t->pending |= bit;
+	if (!(qbman_result_DQ_flags(dq) & QBMAN_DQ_STAT_HELDACTIVE))
+		return 0;
+
+	t->held |= bit;
+	return 1;
+}
+
+int qbman_hold_desc_set_dca(struct qbman_hold_tracker *t,
+			    struct qbman_eq_desc *d,
+			    const struct qbman_result *dq, int park)
+{
+	uint8_t idx = qbman_get_dqrr_idx(dq);
+	uint16_t bit = 1 << idx;
+
+	if (!(t->pending & bit))
+		return 0;
+
+	qbman_eq_desc_set_dca(d, 1, idx, park && (t->held & bit));
+	t->pending &= ~bit;
+	t->held &= ~bit;
+	return 1;
+}
+
+uint32_t qbman_hold_eq_flags(struct qbman_hold_tracker *t,
+			     const struct qbman_result *dq)
+{
+	uint8_t idx = qbman_get_dqrr_idx(dq);
+	uint16_t bit = 1 << idx;
+
+	if (!(t->pending & bit))
+		return 0;
+
+	t->pending &= ~bit;
+	t->held &= ~bit;
+	return QBMAN_ENQUEUE_FLAG_DCA | idx;
+}
+
+int qbman_hold_complete(struct qbman_hold_tracker *t, struct qbman_swp *s)
+{
+	int num = __builtin_popcount(t->pending);
+
+	qbman_swp_dqrr_idx_consume_mask(s, t->pending);
+	t->pending = 0;
+	t->held = 0;
+	return num;
+}
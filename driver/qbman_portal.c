@@ -31,6 +31,11 @@
 
 #include "qbman_portal.h"
 
+#if defined(__ARM_NEON) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+#include <arm_neon.h>
+#define QBMAN_DQ_DECODE_NEON
+#endif
+
 uint32_t qman_version;
 // Uncomment this line to get statistic while the system is running.
 //#define DEBUG_STATS
@@ -141,18 +146,6 @@ static __thread int first_enqueue_run = 1;
 /* opaque token for static dequeues */
 #define QMAN_SDQCR_TOKEN    0xbb
 
-enum qbman_sdqcr_dct {
-	qbman_sdqcr_dct_null = 0,
-	qbman_sdqcr_dct_prio_ics,
-	qbman_sdqcr_dct_active_ics,
-	qbman_sdqcr_dct_active
-};
-
-enum qbman_sdqcr_fc {
-	qbman_sdqcr_fc_one = 0,
-	qbman_sdqcr_fc_up_to_3 = 1
-};
-
 /* We need to keep track of which SWP triggered a pull command
  * so keep an array of portal IDs and use the token field to
  * be able to find the proper portal
@@ -338,6 +331,7 @@ struct qbman_swp *qbman_swp_init(const struct qbman_swp_desc *d)
 		qbman_swp_release_ptr = qbman_swp_release_mem_back;
 	}
 
+	p->eqcr.ci_thresh = 1;
 	for (mask_size = p->eqcr.pi_ring_size; mask_size > 0; mask_size >>= 1)
 		p->eqcr.pi_ci_mask = (p->eqcr.pi_ci_mask << 1) + 1;
 	eqcr_pi = qbman_cinh_read(&p->sys, QBMAN_CINH_SWP_EQCR_PI);
@@ -361,10 +355,23 @@ struct qbman_swp *qbman_swp_init(const struct qbman_swp_desc *d)
 
 void qbman_swp_finish(struct qbman_swp *p)
 {
+	int loopvar = 1000;
+	int lost;
+
 #ifdef QBMAN_CHECKING
 	QBMAN_BUG_ON(p->mc.check != swp_mc_can_start);
 #endif
+	/* Give hardware the frames still held back in software */
+	do {
+		lost = qbman_swp_enqueue_backlog_flush(p);
+	} while (lost && loopvar--);
+	qbman_swp_enqueue_doorbell_flush(p);
+	if (lost)
+		pr_err("qbman: portal %d finished with %d backlogged frames\n",
+		       p->desc.idx, lost);
 	qbman_swp_sys_finish(&p->sys);
+	free(p->eq_backlog.desc);
+	free(p->eq_backlog.fd);
 	portal_idx_map[p->desc.idx] = NULL;
 	free(p);
 }
@@ -535,22 +542,6 @@ void *qbman_swp_mc_result(struct qbman_swp *p)
 /* Enqueue */
 /***********/
 
-#define QB_ENQUEUE_CMD_OPTIONS_SHIFT    0
-enum qb_enqueue_commands {
-	enqueue_empty = 0,
-	enqueue_response_always = 1,
-	enqueue_rejects_to_fq = 2
-};
-
-#define QB_ENQUEUE_CMD_EC_OPTION_MASK		0x3
-#define QB_ENQUEUE_CMD_ORP_ENABLE_SHIFT		2
-#define QB_ENQUEUE_CMD_IRQ_ON_DISPATCH_SHIFT	3
-#define QB_ENQUEUE_CMD_TARGET_TYPE_SHIFT	4
-#define QB_ENQUEUE_CMD_DCA_PK_SHIFT		6
-#define QB_ENQUEUE_CMD_DCA_EN_SHIFT		7
-#define QB_ENQUEUE_CMD_NLIS_SHIFT		14
-#define QB_ENQUEUE_CMD_IS_NESN_SHIFT		15
-
 void qbman_eq_desc_clear(struct qbman_eq_desc *d)
 {
 	memset(d, 0, sizeof(*d));
@@ -671,6 +662,85 @@ static inline void qbman_write_eqcr_am_rt_register(struct qbman_swp *p,
 				     QMAN_RT_MODE);
 }
 
+/* Re-read the EQCR consumer index and credit whatever hardware has consumed
+ * since the last read. This is done whenever availability is below the
+ * low-watermark set by qbman_swp_enqueue_ci_refresh_set() and the caller
+ * wants more than is known to be available, rather than only once the ring is
+ * full, so a burst can use the whole ring. With a watermark above the default
+ * of 1, the CI cacheline is also prefetched once availability drops below it,
+ * so the next refresh mostly hits; the default adds no access to CI.
+ */
+static inline void qbman_swp_eqcr_update_ci(struct qbman_swp *s,
+					    uint32_t ci_offset)
+{
+	uint32_t eqcr_ci = s->eqcr.ci;
+
+	s->eqcr.ci = qbman_cena_read_reg(&s->sys, ci_offset)
+			& s->eqcr.pi_ci_mask;
+	s->eqcr.available += qm_cyc_diff(s->eqcr.pi_ring_size,
+					 eqcr_ci, s->eqcr.ci);
+}
+
+static inline int qbman_swp_eqcr_avail(struct qbman_swp *s,
+				       uint32_t ci_offset, int num_frames)
+{
+	if (s->eqcr.available < num_frames &&
+	    s->eqcr.available < s->eqcr.ci_thresh)
+		qbman_swp_eqcr_update_ci(s, ci_offset);
+	return s->eqcr.available;
+}
+
+static inline void qbman_swp_eqcr_prefetch_ci(struct qbman_swp *s,
+					      uint32_t ci_offset)
+{
+	if (s->eqcr.ci_thresh > 1 && s->eqcr.available < s->eqcr.ci_thresh)
+		qbman_cena_prefetch(&s->sys, ci_offset);
+}
+
+int qbman_swp_enqueue_ci_refresh_set(struct qbman_swp *s, unsigned int thresh)
+{
+	if (!thresh || thresh > s->eqcr.pi_ring_size)
+		return -EINVAL;
+	s->eqcr.ci_thresh = thresh;
+	return 0;
+}
+
+/* In memory-backed mode, EQCR entries are only read by hardware once the
+ * producer index is written to EQCR_PI. That doorbell (and the barrier ahead
+ * of it) can be deferred to cover several enqueue calls, see
+ * qbman_swp_enqueue_doorbell_set(). The doorbell is always rung once the ring
+ * is full so hardware can never be left waiting on entries we hold back.
+ */
+static inline void qbman_swp_eqcr_ring_doorbell(struct qbman_swp *s)
+{
+	s->eqcr.db_pending = 0;
+	dma_wmb();
+	qbman_cinh_write(&s->sys, QBMAN_CINH_SWP_EQCR_PI,
+				(QB_RT_BIT)|(s->eqcr.pi)|s->eqcr.pi_vb);
+}
+
+static inline int qbman_swp_eqcr_doorbell_expired(struct qbman_swp *s)
+{
+	return s->eqcr.db_budget && (read_free_running_frequency_counter()
+				     >= s->eqcr.db_deadline);
+}
+
+static inline void qbman_swp_eqcr_doorbell(struct qbman_swp *s,
+					   int num_enqueued)
+{
+	if (!s->eqcr.db_thresh) {
+		qbman_swp_eqcr_ring_doorbell(s);
+		return;
+	}
+	if (!s->eqcr.db_pending && s->eqcr.db_budget)
+		s->eqcr.db_deadline = read_free_running_frequency_counter()
+					+ s->eqcr.db_budget;
+	s->eqcr.db_pending += num_enqueued;
+	if (s->eqcr.db_pending >= s->eqcr.db_thresh || !s->eqcr.available ||
+	    qbman_swp_eqcr_doorbell_expired(s))
+		qbman_swp_eqcr_ring_doorbell(s);
+}
+
 #ifdef DEBUG_STATS
 static inline void printDebugStats(int num_enqueued)
 {
@@ -780,19 +850,12 @@ static int qbman_swp_enqueue_ring_mode_direct(struct qbman_swp *s,
 {
 	uint32_t *p;
 	const uint32_t *cl = qb_cl(d);
-	uint32_t eqcr_ci, full_mask, half_mask;
+	uint32_t full_mask, half_mask;
 
 	half_mask = (s->eqcr.pi_ci_mask>>1);
 	full_mask = s->eqcr.pi_ci_mask;
-	if (!s->eqcr.available) {
-		eqcr_ci = s->eqcr.ci;
-		s->eqcr.ci = qbman_cena_read_reg(&s->sys,
-			   QBMAN_CENA_SWP_EQCR_CI) & full_mask;
-		s->eqcr.available = qm_cyc_diff(s->eqcr.pi_ring_size,
-				   eqcr_ci, s->eqcr.ci);
-		if (!s->eqcr.available)
-			return -EBUSY;
-	}
+	if (!qbman_swp_eqcr_avail(s, QBMAN_CENA_SWP_EQCR_CI, 1))
+		return -EBUSY;
 
 	p = qbman_cena_write_start_wo_shadow(&s->sys,
 			   QBMAN_CENA_SWP_EQCR(s->eqcr.pi & half_mask));
@@ -807,6 +870,7 @@ static int qbman_swp_enqueue_ring_mode_direct(struct qbman_swp *s,
 	s->eqcr.pi++;
 	s->eqcr.pi &= full_mask;
 	s->eqcr.available--;
+	qbman_swp_eqcr_prefetch_ci(s, QBMAN_CENA_SWP_EQCR_CI);
 	if (!(s->eqcr.pi & half_mask))
 		s->eqcr.pi_vb ^= QB_VALID_BIT;
 
@@ -822,19 +886,12 @@ static int qbman_swp_enqueue_ring_mode_mem_back(struct qbman_swp *s,
 {
 	uint32_t *p;
 	const uint32_t *cl = qb_cl(d);
-	uint32_t eqcr_ci, full_mask, half_mask;
+	uint32_t full_mask, half_mask;
 
 	half_mask = (s->eqcr.pi_ci_mask>>1);
 	full_mask = s->eqcr.pi_ci_mask;
-	if (!s->eqcr.available) {
-		eqcr_ci = s->eqcr.ci;
-		s->eqcr.ci = qbman_cena_read_reg(&s->sys,
-				QBMAN_CENA_SWP_EQCR_CI_MEMBACK) & full_mask;
-		s->eqcr.available = qm_cyc_diff(s->eqcr.pi_ring_size,
-				eqcr_ci, s->eqcr.ci);
-		if (!s->eqcr.available)
-			return -EBUSY;
-	}
+	if (!qbman_swp_eqcr_avail(s, QBMAN_CENA_SWP_EQCR_CI_MEMBACK, 1))
+		return -EBUSY;
 
 	p = qbman_cena_write_start_wo_shadow(&s->sys,
 			QBMAN_CENA_SWP_EQCR(s->eqcr.pi & half_mask));
@@ -846,11 +903,10 @@ static int qbman_swp_enqueue_ring_mode_mem_back(struct qbman_swp *s,
 	s->eqcr.pi++;
 	s->eqcr.pi &= full_mask;
 	s->eqcr.available--;
+	qbman_swp_eqcr_prefetch_ci(s, QBMAN_CENA_SWP_EQCR_CI_MEMBACK);
 	if (!(s->eqcr.pi & half_mask))
 		s->eqcr.pi_vb ^= QB_VALID_BIT;
-	dma_wmb();
-	qbman_cinh_write(&s->sys, QBMAN_CINH_SWP_EQCR_PI,
-				(QB_RT_BIT)|(s->eqcr.pi)|s->eqcr.pi_vb);
+	qbman_swp_eqcr_doorbell(s, 1);
 
 #ifdef DEBUG_STATS
 	printDebugStats(1);
@@ -865,13 +921,180 @@ static int qbman_swp_enqueue_ring_mode(struct qbman_swp *s,
 	return qbman_swp_enqueue_ring_mode_ptr(s, d, fd);
 }
 
+/****************/
+/* EQCR backlog */
+/****************/
+
+#define QBMAN_EQ_BACKLOG_MAX	(1 << 16)
+
+static inline int qbman_swp_enqueue_backlog_empty(struct qbman_swp *s)
+{
+	return s->eq_backlog.head == s->eq_backlog.tail;
+}
+
+/* Copy frames the EQCR could not take into the backlog. Each entry keeps its
+ * own copy of the descriptor, with any per-frame DCA flag folded in, so the
+ * backlog can be drained with qbman_swp_enqueue_multiple_desc(). 'd' is an
+ * array of 'num_frames' descriptors if 'multi_desc' is set.
+ */
+static int qbman_swp_enqueue_backlog_push(struct qbman_swp *s,
+					  const struct qbman_eq_desc *d,
+					  int multi_desc,
+					  const struct qbman_fd *fd,
+					  const uint32_t *flags,
+					  int num_frames)
+{
+	uint32_t mask = s->eq_backlog.size - 1;
+	uint32_t idx;
+	int i, room;
+
+	room = s->eq_backlog.size - (s->eq_backlog.tail - s->eq_backlog.head);
+	if (num_frames > room)
+		num_frames = room;
+
+	for (i = 0; i < num_frames; i++) {
+		idx = (s->eq_backlog.tail + i) & mask;
+		memcpy(&s->eq_backlog.desc[idx], multi_desc ? &d[i] : d,
+		       sizeof(*d));
+		if (flags && (flags[i] & QBMAN_ENQUEUE_FLAG_DCA))
+			qbman_eq_desc_set_dca(&s->eq_backlog.desc[idx], 1,
+					flags[i] & QBMAN_EQCR_DCA_IDXMASK, 0);
+		if (fd)
+			memcpy(&s->eq_backlog.fd[idx], &fd[i], sizeof(*fd));
+		else
+			memset(&s->eq_backlog.fd[idx], 0, sizeof(*fd));
+	}
+	s->eq_backlog.tail += num_frames;
+
+	return num_frames;
+}
+
+/* Move as much of the backlog as the EQCR currently has room for, oldest
+ * first. The EQCR consumer index is only re-read when the ring is full, so
+ * this is cheap when hardware hasn't made progress. Returns the number of
+ * frames still held in the backlog.
+ */
+static int qbman_swp_enqueue_backlog_drain(struct qbman_swp *s)
+{
+	uint32_t mask = s->eq_backlog.size - 1;
+	uint32_t idx;
+	int num, ret;
+
+	while (!qbman_swp_enqueue_backlog_empty(s)) {
+		idx = s->eq_backlog.head & mask;
+		num = s->eq_backlog.tail - s->eq_backlog.head;
+		if (num > (int)(s->eq_backlog.size - idx))
+			num = s->eq_backlog.size - idx;
+
+		if (s->sys.eqcr_mode == qman_eqcr_vb_array)
+			ret = qbman_swp_enqueue_array_mode(s,
+					&s->eq_backlog.desc[idx],
+					&s->eq_backlog.fd[idx]) ? 0 : 1;
+		else
+			ret = qbman_swp_enqueue_multiple_desc_ptr(s,
+					&s->eq_backlog.desc[idx],
+					&s->eq_backlog.fd[idx], num);
+		if (ret <= 0)
+			break;
+		s->eq_backlog.head += ret;
+	}
+
+	return s->eq_backlog.tail - s->eq_backlog.head;
+}
+
+int qbman_swp_enqueue_backlog_set(struct qbman_swp *s, unsigned int depth)
+{
+	struct qbman_eq_desc *desc = NULL;
+	struct qbman_fd *fd = NULL;
+	uint32_t size = 0;
+
+	if (depth > QBMAN_EQ_BACKLOG_MAX)
+		return -EINVAL;
+	if (!qbman_swp_enqueue_backlog_empty(s))
+		return -EBUSY;
+
+	if (depth) {
+		for (size = 1; size < depth; size <<= 1)
+			;
+		desc = malloc(size * sizeof(*desc));
+		fd = malloc(size * sizeof(*fd));
+		if (!desc || !fd) {
+			free(desc);
+			free(fd);
+			return -ENOMEM;
+		}
+	}
+
+	free(s->eq_backlog.desc);
+	free(s->eq_backlog.fd);
+	s->eq_backlog.desc = desc;
+	s->eq_backlog.fd = fd;
+	s->eq_backlog.size = size;
+	s->eq_backlog.head = 0;
+	s->eq_backlog.tail = 0;
+
+	return 0;
+}
+
+int qbman_swp_enqueue_backlog_flush(struct qbman_swp *s)
+{
+	if (qbman_swp_enqueue_backlog_empty(s))
+		return 0;
+	return qbman_swp_enqueue_backlog_drain(s);
+}
+
+unsigned int qbman_swp_enqueue_backlog_depth(struct qbman_swp *s)
+{
+	return s->eq_backlog.tail - s->eq_backlog.head;
+}
+
+/*********************/
+/* Deferred doorbell */
+/*********************/
+
+int qbman_swp_enqueue_doorbell_set(struct qbman_swp *s, unsigned int thresh,
+				   uint64_t budget)
+{
+	if ((s->desc.qman_version & QMAN_REV_MASK) < QMAN_REV_5000 ||
+	    s->desc.cena_access_mode != qman_cena_fastest_access)
+		return -ENOTSUP;
+	if (thresh > s->eqcr.pi_ring_size)
+		return -EINVAL;
+
+	if (s->eqcr.db_pending)
+		qbman_swp_eqcr_ring_doorbell(s);
+	s->eqcr.db_thresh = thresh;
+	s->eqcr.db_budget = thresh ? budget : 0;
+
+	return 0;
+}
+
+void qbman_swp_enqueue_doorbell_flush(struct qbman_swp *s)
+{
+	if (s->eqcr.db_pending)
+		qbman_swp_eqcr_ring_doorbell(s);
+}
+
 int qbman_swp_enqueue(struct qbman_swp *s, const struct qbman_eq_desc *d,
 		      const struct qbman_fd *fd)
 {
+	int ret;
+
+	/* Frames must not overtake what is already waiting in the backlog */
+	if (!qbman_swp_enqueue_backlog_empty(s) &&
+	    qbman_swp_enqueue_backlog_drain(s))
+		return qbman_swp_enqueue_backlog_push(s, d, 0, fd,
+						      NULL, 1) ? 0 : -EBUSY;
+
 	if (s->sys.eqcr_mode == qman_eqcr_vb_array)
-		return qbman_swp_enqueue_array_mode(s, d, fd);
+		ret = qbman_swp_enqueue_array_mode(s, d, fd);
 	else    /* Use ring mode by default */
-		return qbman_swp_enqueue_ring_mode(s, d, fd);
+		ret = qbman_swp_enqueue_ring_mode(s, d, fd);
+
+	if (ret == -EBUSY && s->eq_backlog.size)
+		ret = qbman_swp_enqueue_backlog_push(s, d, 0, fd,
+						     NULL, 1) ? 0 : -EBUSY;
+	return ret;
 }
 
 static int qbman_swp_enqueue_multiple_direct(struct qbman_swp *s,
@@ -882,27 +1105,21 @@ static int qbman_swp_enqueue_multiple_direct(struct qbman_swp *s,
 {
 	uint32_t *p = NULL;
 	const uint32_t *cl = qb_cl(d);
-	uint32_t eqcr_ci, eqcr_pi, half_mask, full_mask;
+	uint32_t eqcr_pi, half_mask, full_mask;
 	int i, num_enqueued = 0;
 	uint64_t addr_cena;
 
 	half_mask = (s->eqcr.pi_ci_mask>>1);
 	full_mask = s->eqcr.pi_ci_mask;
 
-	if (!s->eqcr.available) {
-		eqcr_ci = s->eqcr.ci;
-		s->eqcr.ci = qbman_cena_read_reg(&s->sys,
-				QBMAN_CENA_SWP_EQCR_CI) & full_mask;
-		s->eqcr.available = qm_cyc_diff(s->eqcr.pi_ring_size,
-				   eqcr_ci, s->eqcr.ci);
-		if (!s->eqcr.available)
-			return 0;
-	}
+	if (!qbman_swp_eqcr_avail(s, QBMAN_CENA_SWP_EQCR_CI, num_frames))
+		return 0;
 
 	eqcr_pi = s->eqcr.pi;
 	num_enqueued = (s->eqcr.available < num_frames) ?
 			s->eqcr.available : num_frames;
 	s->eqcr.available -= num_enqueued;
+	qbman_swp_eqcr_prefetch_ci(s, QBMAN_CENA_SWP_EQCR_CI);
 	/* Fill in the EQCR ring */
 	for (i = 0; i < num_enqueued; i++) {
 		p = qbman_cena_write_start_wo_shadow(&s->sys,
@@ -954,25 +1171,19 @@ static int qbman_swp_enqueue_multiple_mem_back(struct qbman_swp *s,
 {
 	uint32_t *p = NULL;
 	const uint32_t *cl = qb_cl(d);
-	uint32_t eqcr_ci, eqcr_pi, half_mask, full_mask;
+	uint32_t eqcr_pi, half_mask, full_mask;
 	int i, num_enqueued = 0;
 
 	half_mask = (s->eqcr.pi_ci_mask>>1);
 	full_mask = s->eqcr.pi_ci_mask;
-	if (!s->eqcr.available) {
-		eqcr_ci = s->eqcr.ci;
-		s->eqcr.ci = qbman_cena_read_reg(&s->sys,
-				QBMAN_CENA_SWP_EQCR_CI_MEMBACK) & full_mask;
-		s->eqcr.available = qm_cyc_diff(s->eqcr.pi_ring_size,
-					eqcr_ci, s->eqcr.ci);
-		if (!s->eqcr.available)
-			return 0;
-	}
+	if (!qbman_swp_eqcr_avail(s, QBMAN_CENA_SWP_EQCR_CI_MEMBACK, num_frames))
+		return 0;
 
 	eqcr_pi = s->eqcr.pi;
 	num_enqueued = (s->eqcr.available < num_frames) ?
 			s->eqcr.available : num_frames;
 	s->eqcr.available -= num_enqueued;
+	qbman_swp_eqcr_prefetch_ci(s, QBMAN_CENA_SWP_EQCR_CI_MEMBACK);
 	/* Fill in the EQCR ring */
 	for (i = 0; i < num_enqueued; i++) {
 		p = qbman_cena_write_start_wo_shadow(&s->sys,
@@ -1000,9 +1211,7 @@ static int qbman_swp_enqueue_multiple_mem_back(struct qbman_swp *s,
 	}
 	s->eqcr.pi = eqcr_pi & full_mask;
 
-	dma_wmb();
-	qbman_cinh_write(&s->sys, QBMAN_CINH_SWP_EQCR_PI,
-				(QB_RT_BIT)|(s->eqcr.pi)|s->eqcr.pi_vb);
+	qbman_swp_eqcr_doorbell(s, num_enqueued);
 
 #ifdef DEBUG_STATS
 	printDebugStats(num_enqueued);
@@ -1016,7 +1225,55 @@ inline int qbman_swp_enqueue_multiple(struct qbman_swp *s,
 			       uint32_t *flags,
 			       int num_frames)
 {
-	return qbman_swp_enqueue_multiple_ptr(s, d, fd, flags, num_frames);
+	int ret;
+
+	if (!qbman_swp_enqueue_backlog_empty(s) &&
+	    qbman_swp_enqueue_backlog_drain(s))
+		return qbman_swp_enqueue_backlog_push(s, d, 0, fd, flags,
+						      num_frames);
+
+	ret = qbman_swp_enqueue_multiple_ptr(s, d, fd, flags, num_frames);
+	if (ret < num_frames && s->eq_backlog.size)
+		ret += qbman_swp_enqueue_backlog_push(s, d, 0, &fd[ret],
+					flags ? &flags[ret] : NULL,
+					num_frames - ret);
+	return ret;
+}
+
+int qbman_swp_enqueue_burst(struct qbman_swp *s,
+			    const struct qbman_eq_desc *d,
+			    const struct qbman_fd *fd,
+			    uint32_t *flags,
+			    int num_frames,
+			    uint64_t budget)
+{
+	uint64_t now, deadline = 0;
+	int ret, num_enqueued = 0;
+
+	while (num_enqueued < num_frames) {
+		ret = qbman_swp_enqueue_multiple(s, d, &fd[num_enqueued],
+					flags ? &flags[num_enqueued] : NULL,
+					num_frames - num_enqueued);
+		if (ret > 0) {
+			num_enqueued += ret;
+			continue;
+		}
+
+		/* EQCR is full, only spin on it for as long as allowed. The
+		 * clock is read once the ring fills, not per chunk.
+		 */
+		if (!budget)
+			break;
+		now = read_free_running_frequency_counter();
+		if (!deadline)
+			deadline = now + budget;
+		else if (now >= deadline)
+			break;
+	}
+
+	/* Don't leave the tail of the burst waiting on a deferred doorbell */
+	qbman_swp_enqueue_doorbell_flush(s);
+	return num_enqueued;
 }
 
 static int qbman_swp_enqueue_multiple_desc_direct(struct qbman_swp *s,
@@ -1026,26 +1283,20 @@ static int qbman_swp_enqueue_multiple_desc_direct(struct qbman_swp *s,
 {
 	uint32_t *p;
 	const uint32_t *cl;
-	uint32_t eqcr_ci, eqcr_pi, half_mask, full_mask;
+	uint32_t eqcr_pi, half_mask, full_mask;
 	int i, num_enqueued = 0;
 	uint64_t addr_cena;
 
 	half_mask = (s->eqcr.pi_ci_mask>>1);
 	full_mask = s->eqcr.pi_ci_mask;
-	if (!s->eqcr.available) {
-		eqcr_ci = s->eqcr.ci;
-		s->eqcr.ci = qbman_cena_read_reg(&s->sys,
-				QBMAN_CENA_SWP_EQCR_CI) & full_mask;
-		s->eqcr.available = qm_cyc_diff(s->eqcr.pi_ring_size,
-					eqcr_ci, s->eqcr.ci);
-		if (!s->eqcr.available)
-			return 0;
-	}
+	if (!qbman_swp_eqcr_avail(s, QBMAN_CENA_SWP_EQCR_CI, num_frames))
+		return 0;
 
 	eqcr_pi = s->eqcr.pi;
 	num_enqueued = (s->eqcr.available < num_frames) ?
 			s->eqcr.available : num_frames;
 	s->eqcr.available -= num_enqueued;
+	qbman_swp_eqcr_prefetch_ci(s, QBMAN_CENA_SWP_EQCR_CI);
 	/* Fill in the EQCR ring */
 	for (i = 0; i < num_enqueued; i++) {
 		p = qbman_cena_write_start_wo_shadow(&s->sys,
@@ -1093,25 +1344,19 @@ static int qbman_swp_enqueue_multiple_desc_mem_back(struct qbman_swp *s,
 {
 	uint32_t *p;
 	const uint32_t *cl;
-	uint32_t eqcr_ci, eqcr_pi, half_mask, full_mask;
+	uint32_t eqcr_pi, half_mask, full_mask;
 	int i, num_enqueued = 0;
 
 	half_mask = (s->eqcr.pi_ci_mask>>1);
 	full_mask = s->eqcr.pi_ci_mask;
-	if (!s->eqcr.available) {
-		eqcr_ci = s->eqcr.ci;
-		s->eqcr.ci = qbman_cena_read_reg(&s->sys,
-				QBMAN_CENA_SWP_EQCR_CI_MEMBACK) & full_mask;
-		s->eqcr.available = qm_cyc_diff(s->eqcr.pi_ring_size,
-					eqcr_ci, s->eqcr.ci);
-		if (!s->eqcr.available)
-			return 0;
-	}
+	if (!qbman_swp_eqcr_avail(s, QBMAN_CENA_SWP_EQCR_CI_MEMBACK, num_frames))
+		return 0;
 
 	eqcr_pi = s->eqcr.pi;
 	num_enqueued = (s->eqcr.available < num_frames) ?
 			s->eqcr.available : num_frames;
 	s->eqcr.available -= num_enqueued;
+	qbman_swp_eqcr_prefetch_ci(s, QBMAN_CENA_SWP_EQCR_CI_MEMBACK);
 	/* Fill in the EQCR ring */
 	for (i = 0; i < num_enqueued; i++) {
 		p = qbman_cena_write_start_wo_shadow(&s->sys,
@@ -1136,9 +1381,7 @@ static int qbman_swp_enqueue_multiple_desc_mem_back(struct qbman_swp *s,
 
 	s->eqcr.pi = eqcr_pi & full_mask;
 
-	dma_wmb();
-	qbman_cinh_write(&s->sys, QBMAN_CINH_SWP_EQCR_PI,
-				(QB_RT_BIT)|(s->eqcr.pi)|s->eqcr.pi_vb);
+	qbman_swp_eqcr_doorbell(s, num_enqueued);
 
 #ifdef DEBUG_STATS
 	printDebugStats(num_enqueued);
@@ -1150,13 +1393,94 @@ inline int qbman_swp_enqueue_multiple_desc(struct qbman_swp *s,
 				    const struct qbman_fd *fd,
 				    int num_frames)
 {
-	return qbman_swp_enqueue_multiple_desc_ptr(s, d, fd, num_frames);
+	int ret;
+
+	if (!qbman_swp_enqueue_backlog_empty(s) &&
+	    qbman_swp_enqueue_backlog_drain(s))
+		return qbman_swp_enqueue_backlog_push(s, d, 1, fd, NULL,
+						      num_frames);
+
+	ret = qbman_swp_enqueue_multiple_desc_ptr(s, d, fd, num_frames);
+	if (ret < num_frames && s->eq_backlog.size)
+		ret += qbman_swp_enqueue_backlog_push(s, &d[ret], 1, &fd[ret],
+						      NULL, num_frames - ret);
+	return ret;
+}
+
+/**********************/
+/* DQRR to EQCR relay */
+/**********************/
+
+#define QBMAN_FORWARD_BURST_MAX	16
+
+int qbman_swp_forward_burst(struct qbman_swp *s,
+			    const struct qbman_eq_desc *d,
+			    const struct qbman_result **dq,
+			    int num_frames,
+			    qbman_swp_forward_cb cb,
+			    void *ctx)
+{
+	struct qbman_eq_desc eqd[QBMAN_FORWARD_BURST_MAX];
+	struct qbman_fd fd[QBMAN_FORWARD_BURST_MAX];
+	uint8_t pos[QBMAN_FORWARD_BURST_MAX];
+	uint8_t dropped[QBMAN_FORWARD_BURST_MAX];
+	int i, n, num, ret, done, num_done = 0;
+	uint32_t fqid;
+
+	while (num_done < num_frames) {
+		num = num_frames - num_done;
+		if (num > QBMAN_FORWARD_BURST_MAX)
+			num = QBMAN_FORWARD_BURST_MAX;
+
+		n = 0;
+		for (i = 0; i < num; i++) {
+			const struct qbman_result *r = dq[num_done + i];
+
+			memcpy(&fd[n], qbman_result_DQ_fd(r), sizeof(*fd));
+			dropped[i] = !!cb(ctx, r, &fd[n], &fqid);
+			if (dropped[i])
+				continue;
+			memcpy(&eqd[n], d, sizeof(*d));
+			qbman_eq_desc_set_fq(&eqd[n], fqid);
+			qbman_eq_desc_set_dca(&eqd[n], 1, qbman_get_dqrr_idx(r),
+					      0);
+			pos[n++] = i;
+		}
+
+		ret = n ? qbman_swp_enqueue_multiple_desc(s, eqd, fd, n) : 0;
+
+		/* Everything ahead of the first frame the EQCR didn't take is
+		 * done. Dropped entries have no enqueue to carry the DCA, so
+		 * consume those directly, but only once we know they are not
+		 * being handed back to the caller.
+		 */
+		done = (ret < n) ? pos[ret] : num;
+		for (i = 0; i < done; i++)
+			if (dropped[i])
+				qbman_swp_dqrr_consume(s, dq[num_done + i]);
+		num_done += done;
+		if (done < num)
+			break;
+	}
+
+	return num_done;
 }
 
 /*************************/
 /* Static (push) dequeue */
 /*************************/
 
+/* If no channels are enabled the SDQCR must be 0 or else QMan will assert
+ * errors
+ */
+static void qbman_swp_push_write(struct qbman_swp *s)
+{
+	if ((s->sdq >> QB_SDQCR_SRC_SHIFT) & QB_SDQCR_SRC_MASK)
+		qbman_cinh_write(&s->sys, QBMAN_CINH_SWP_SDQCR, s->sdq);
+	else
+		qbman_cinh_write(&s->sys, QBMAN_CINH_SWP_SDQCR, 0);
+}
+
 void qbman_swp_push_get(struct qbman_swp *s, uint8_t channel_idx, int *enabled)
 {
 	uint16_t src = (s->sdq >> QB_SDQCR_SRC_SHIFT) & QB_SDQCR_SRC_MASK;
@@ -1167,22 +1491,40 @@ void qbman_swp_push_get(struct qbman_swp *s, uint8_t channel_idx, int *enabled)
 
 void qbman_swp_push_set(struct qbman_swp *s, uint8_t channel_idx, int enable)
 {
-	uint16_t dqsrc;
-
 	QBMAN_BUG_ON(channel_idx > 15);
 	if (enable)
 		s->sdq |= 1 << channel_idx;
 	else
 		s->sdq &= ~(1 << channel_idx);
 
-	/* Read make the complete src map.  If no channels are enabled
-	 * the SDQCR must be 0 or else QMan will assert errors
-	 */
-	dqsrc = (s->sdq >> QB_SDQCR_SRC_SHIFT) & QB_SDQCR_SRC_MASK;
-	if (dqsrc != 0)
-		qbman_cinh_write(&s->sys, QBMAN_CINH_SWP_SDQCR, s->sdq);
-	else
-		qbman_cinh_write(&s->sys, QBMAN_CINH_SWP_SDQCR, 0);
+	qbman_swp_push_write(s);
+}
+
+uint16_t qbman_swp_push_get_mask(struct qbman_swp *s)
+{
+	return (s->sdq >> QB_SDQCR_SRC_SHIFT) & QB_SDQCR_SRC_MASK;
+}
+
+void qbman_swp_push_set_mask(struct qbman_swp *s, uint16_t channel_mask)
+{
+	s->sdq &= ~(QB_SDQCR_SRC_MASK << QB_SDQCR_SRC_SHIFT);
+	s->sdq |= (uint32_t)channel_mask << QB_SDQCR_SRC_SHIFT;
+	qbman_swp_push_write(s);
+}
+
+int qbman_swp_push_set_mode(struct qbman_swp *s, enum qbman_sdqcr_dct dct,
+			    enum qbman_sdqcr_fc fc)
+{
+	if ((unsigned int)dct > QB_SDQCR_DCT_MASK ||
+	    (unsigned int)fc > QB_SDQCR_FC_MASK)
+		return -EINVAL;
+
+	s->sdq &= ~((QB_SDQCR_DCT_MASK << QB_SDQCR_DCT_SHIFT) |
+		    (QB_SDQCR_FC_MASK << QB_SDQCR_FC_SHIFT));
+	s->sdq |= dct << QB_SDQCR_DCT_SHIFT;
+	s->sdq |= fc << QB_SDQCR_FC_SHIFT;
+	qbman_swp_push_write(s);
+	return 0;
 }
 
 /***************************/
@@ -1377,6 +1719,12 @@ inline int qbman_swp_pull(struct qbman_swp *s, struct qbman_pull_desc *d)
 #define QBMAN_RESULT_BPSCN	0x29
 #define QBMAN_RESULT_CSCN_WQ	0x2a
 
+static inline const struct qbman_fd *__qbman_result_DQ_fd(
+					const struct qbman_result *dq)
+{
+	return (const struct qbman_fd *)&dq->dq.fd[0];
+}
+
 #ifndef rte_prefetch0
 static inline void rte_prefetch0(const volatile void *p)
 {
@@ -1388,17 +1736,69 @@ void qbman_swp_prefetch_dqrr_next(struct qbman_swp *s)
 {
 	const struct qbman_result *p;
 
-	p = qbman_cena_read_wo_shadow(&s->sys,
-		QBMAN_CENA_SWP_DQRR(s->dqrr.next_idx));
+	if ((s->desc.qman_version & QMAN_REV_MASK) >= QMAN_REV_5000
+	    && (s->desc.cena_access_mode == qman_cena_fastest_access))
+		p = qbman_cena_read_wo_shadow(&s->sys,
+			QBMAN_CENA_SWP_DQRR_MEM(s->dqrr.next_idx));
+	else
+		p = qbman_cena_read_wo_shadow(&s->sys,
+			QBMAN_CENA_SWP_DQRR(s->dqrr.next_idx));
 	rte_prefetch0(p);
 }
 
+int qbman_swp_dqrr_ready(struct qbman_swp *s)
+{
+	const struct qbman_result *p;
+
+	/* Valid-bits can't be trusted yet, let qbman_swp_dqrr_next() check */
+	if (s->dqrr.reset_bug)
+		return 1;
+
+	if ((s->desc.qman_version & QMAN_REV_MASK) >= QMAN_REV_5000
+	    && (s->desc.cena_access_mode == qman_cena_fastest_access))
+		p = qbman_cena_read_wo_shadow(&s->sys,
+			QBMAN_CENA_SWP_DQRR_MEM(s->dqrr.next_idx));
+	else
+		p = qbman_cena_read_wo_shadow(&s->sys,
+			QBMAN_CENA_SWP_DQRR(s->dqrr.next_idx));
+	return (p->dq.verb & QB_VALID_BIT) == s->dqrr.valid_bit;
+}
+
+int qbman_swp_dqrr_prefetch_set(struct qbman_swp *s,
+				enum qbman_dqrr_prefetch_e mode)
+{
+	switch (mode) {
+	case qbman_dqrr_prefetch_none:
+	case qbman_dqrr_prefetch_next:
+	case qbman_dqrr_prefetch_inval_next:
+		s->dqrr.prefetch = mode;
+		return 0;
+	default:
+		return -EINVAL;
+	}
+}
+
+/* Pull the line of the entry following the one being returned into L1 */
+static inline void qbman_swp_dqrr_prefetch_line(struct qbman_swp *s,
+						uint32_t offset)
+{
+	if (s->dqrr.prefetch == qbman_dqrr_prefetch_inval_next)
+		qbman_cena_invalidate_prefetch(&s->sys, offset);
+	else
+		qbman_cena_prefetch(&s->sys, offset);
+}
+
 /* NULL return if there are no unconsumed DQRR entries. Returns a DQRR entry
  * only once, so repeated calls can return a sequence of DQRR entries, without
  * requiring they be consumed immediately or in any particular order.
  */
 inline const struct qbman_result *qbman_swp_dqrr_next(struct qbman_swp *s)
 {
+	/* Opportunistically move backlogged frames onto the EQCR */
+	if (!qbman_swp_enqueue_backlog_empty(s))
+		qbman_swp_enqueue_backlog_drain(s);
+	if (s->eqcr.db_pending && qbman_swp_eqcr_doorbell_expired(s))
+		qbman_swp_eqcr_ring_doorbell(s);
 	return qbman_swp_dqrr_next_ptr(s);
 }
 
@@ -1466,6 +1866,9 @@ const struct qbman_result *qbman_swp_dqrr_next_direct(struct qbman_swp *s)
 		s->dqrr.next_idx = 0;
 		s->dqrr.valid_bit ^= QB_VALID_BIT;
 	}
+	if (s->dqrr.prefetch)
+		qbman_swp_dqrr_prefetch_line(s,
+			QBMAN_CENA_SWP_DQRR(s->dqrr.next_idx));
 	/* If this is the final response to a volatile dequeue command
 	 * indicate that the vdq is no longer busy
 	 */
@@ -1509,6 +1912,9 @@ const struct qbman_result *qbman_swp_dqrr_next_mem_back(struct qbman_swp *s)
 		s->dqrr.next_idx = 0;
 		s->dqrr.valid_bit ^= QB_VALID_BIT;
 	}
+	if (s->dqrr.prefetch)
+		qbman_swp_dqrr_prefetch_line(s,
+			QBMAN_CENA_SWP_DQRR_MEM(s->dqrr.next_idx));
 	/* If this is the final response to a volatile dequeue command
 	 * indicate that the vdq is no longer busy
 	 */
@@ -1535,6 +1941,93 @@ void qbman_swp_dqrr_idx_consume(struct qbman_swp *s,
 	qbman_cinh_write(&s->sys, QBMAN_CINH_SWP_DCAP, dqrr_index);
 }
 
+/* Consume a set of DQRR entries with back to back DCAP writes */
+void qbman_swp_dqrr_idx_consume_mask(struct qbman_swp *s, uint16_t mask)
+{
+	while (mask) {
+		qbman_cinh_write(&s->sys, QBMAN_CINH_SWP_DCAP,
+				 __builtin_ctz(mask));
+		mask &= mask - 1;
+	}
+}
+
+/*******************/
+/* Harvesting DQRR */
+/*******************/
+
+int qbman_swp_fd_prefetch_set(struct qbman_swp *s, uint32_t flags,
+			      uint32_t distance, qbman_iova_to_va_cb iova2va)
+{
+	if (flags & ~(QBMAN_PREFETCH_FD_DATA | QBMAN_PREFETCH_FQD_CTX))
+		return -EINVAL;
+
+	s->fd_prefetch.flags = distance ? flags : 0;
+	s->fd_prefetch.distance = distance;
+	s->fd_prefetch.iova2va = iova2va;
+	return 0;
+}
+
+void qbman_swp_prefetch_fd(struct qbman_swp *s, const struct qbman_result *dq)
+{
+	const struct qbman_fd *fd;
+	uint64_t addr;
+
+	if (!(dq->dq.stat & QBMAN_DQ_STAT_VALIDFRAME) ||
+	    ((dq->dq.verb & QBMAN_RESPONSE_VERB_MASK) != QBMAN_RESULT_DQ))
+		return;
+
+	if (s->fd_prefetch.flags & QBMAN_PREFETCH_FD_DATA) {
+		fd = __qbman_result_DQ_fd(dq);
+		addr = ((uint64_t)fd->simple.addr_hi << 32) |
+			fd->simple.addr_lo;
+		addr += (fd->simple.bpid_offset >> QB_FD_OFFSET_SHIFT) &
+			QB_FD_OFFSET_MASK;
+		if (s->fd_prefetch.iova2va)
+			prefetch_for_load(s->fd_prefetch.iova2va(addr));
+		else
+			prefetch_for_load((void *)(uintptr_t)addr);
+	}
+	if ((s->fd_prefetch.flags & QBMAN_PREFETCH_FQD_CTX) && dq->dq.fqd_ctx)
+		prefetch_for_load((void *)(uintptr_t)dq->dq.fqd_ctx);
+}
+
+void qbman_swp_prefetch_fd_window(struct qbman_swp *s,
+				  const struct qbman_result **dq,
+				  int num, int i)
+{
+	int ahead = i + (int)s->fd_prefetch.distance;
+
+	if (s->fd_prefetch.flags && ahead < num)
+		qbman_swp_prefetch_fd(s, dq[ahead]);
+}
+
+int qbman_swp_dqrr_next_burst(struct qbman_swp *s,
+			      const struct qbman_result **dq, int num)
+{
+	const struct qbman_result *p;
+	int ahead = (int)s->fd_prefetch.distance;
+	int i;
+
+	if (!qbman_swp_enqueue_backlog_empty(s))
+		qbman_swp_enqueue_backlog_drain(s);
+	if (s->eqcr.db_pending && qbman_swp_eqcr_doorbell_expired(s))
+		qbman_swp_eqcr_ring_doorbell(s);
+
+	/* Frame data for the first 'distance' entries is requested while the
+	 * rest of the ring is still being polled, the caller keeps the window
+	 * going with qbman_swp_prefetch_fd_window().
+	 */
+	for (i = 0; i < num; i++) {
+		p = qbman_swp_dqrr_next_ptr(s);
+		if (!p)
+			break;
+		dq[i] = p;
+		if (s->fd_prefetch.flags && i < ahead)
+			qbman_swp_prefetch_fd(s, p);
+	}
+	return i;
+}
+
 /*********************************/
 /* Polling user-provided storage */
 /*********************************/
@@ -1542,6 +2035,9 @@ void qbman_swp_dqrr_idx_consume(struct qbman_swp *s,
 int qbman_result_has_new_result(struct qbman_swp *s,
 				struct qbman_result *dq)
 {
+	if (!qbman_swp_enqueue_backlog_empty(s))
+		qbman_swp_enqueue_backlog_drain(s);
+
 	if (dq->dq.tok == 0)
 		return 0;
 
@@ -1690,6 +2186,78 @@ int qbman_result_is_FQPN(const struct qbman_result *dq)
 	return __qbman_result_is_x(dq, QBMAN_RESULT_FQPN);
 }
 
+/***********************/
+/* Dispatching results */
+/***********************/
+
+void qbman_result_dispatch_init(struct qbman_result_dispatch *t,
+				qbman_result_handler handler, void *ctx)
+{
+	int i;
+
+	for (i = 0; i < QBMAN_RESULT_DISPATCH_SIZE; i++) {
+		t->tbl[i].handler = handler;
+		t->tbl[i].ctx = ctx;
+	}
+}
+
+int qbman_result_dispatch_register(struct qbman_result_dispatch *t,
+				   enum qbman_result_type type,
+				   qbman_result_handler handler, void *ctx)
+{
+	static const uint8_t verbs[][2] = {
+		[qbman_result_type_dq] = { QBMAN_RESULT_DQ, 0 },
+		[qbman_result_type_fqdan] = { QBMAN_RESULT_FQDAN, 0 },
+		[qbman_result_type_cdan] = { QBMAN_RESULT_CDAN, 0 },
+		[qbman_result_type_cscn] = { QBMAN_RESULT_CSCN_MEM,
+					     QBMAN_RESULT_CSCN_WQ },
+		[qbman_result_type_bpscn] = { QBMAN_RESULT_BPSCN, 0 },
+		[qbman_result_type_cgcu] = { QBMAN_RESULT_CGCU, 0 },
+		[qbman_result_type_fqrn] = { QBMAN_RESULT_FQRN, 0 },
+		[qbman_result_type_fqrni] = { QBMAN_RESULT_FQRNI, 0 },
+		[qbman_result_type_fqpn] = { QBMAN_RESULT_FQPN, 0 },
+	};
+	unsigned int i;
+
+	if ((unsigned int)type >= sizeof(verbs) / sizeof(verbs[0]))
+		return -EINVAL;
+
+	for (i = 0; i < 2 && verbs[type][i]; i++) {
+		t->tbl[verbs[type][i]].handler = handler;
+		t->tbl[verbs[type][i]].ctx = ctx;
+	}
+
+	return 0;
+}
+
+int qbman_result_dispatch_burst(const struct qbman_result_dispatch *t,
+				struct qbman_swp *s,
+				const struct qbman_result **dq,
+				int num)
+{
+	qbman_result_handler dq_handler = t->tbl[QBMAN_RESULT_DQ].handler;
+	void *dq_ctx = t->tbl[QBMAN_RESULT_DQ].ctx;
+	uint8_t verb;
+	int i, num_handled = 0;
+
+	for (i = 0; i < num; i++) {
+		verb = dq[i]->dq.verb & QBMAN_RESPONSE_VERB_MASK;
+
+		/* Frames are the common case, keep them off the table */
+		if (verb == QBMAN_RESULT_DQ) {
+			if (dq_handler) {
+				dq_handler(dq_ctx, s, dq[i]);
+				num_handled++;
+			}
+		} else if (t->tbl[verb].handler) {
+			t->tbl[verb].handler(t->tbl[verb].ctx, s, dq[i]);
+			num_handled++;
+		}
+	}
+
+	return num_handled;
+}
+
 /*********************************/
 /* Parsing frame dequeue results */
 /*********************************/
@@ -1736,6 +2304,65 @@ const struct qbman_fd *qbman_result_DQ_fd(const struct qbman_result *dq)
 	return (const struct qbman_fd *)&dq->dq.fd[0];
 }
 
+void qbman_result_DQ_decode_burst(const struct qbman_result **dq, int num,
+				  const struct qbman_dq_meta *m)
+{
+	const struct qbman_fd *fd;
+	int i = 0;
+
+#ifdef QBMAN_DQ_DECODE_NEON
+	/* Four results at a time: load FD words 0-3 (addr_lo, addr_hi, len,
+	 * bpid_offset) of each, transpose so len and bpid_offset of all four
+	 * land in one vector each, and split bpid/offset with lane-wise ops.
+	 */
+	for (; i + 4 <= num; i += 4) {
+		uint32x4_t v0 = vld1q_u32(__qbman_result_DQ_fd(dq[i])->words);
+		uint32x4_t v1 = vld1q_u32(__qbman_result_DQ_fd(dq[i + 1])->words);
+		uint32x4_t v2 = vld1q_u32(__qbman_result_DQ_fd(dq[i + 2])->words);
+		uint32x4_t v3 = vld1q_u32(__qbman_result_DQ_fd(dq[i + 3])->words);
+		uint32x4x2_t t01 = vtrnq_u32(v0, v1);
+		uint32x4x2_t t23 = vtrnq_u32(v2, v3);
+		uint32x4_t len = vcombine_u32(vget_high_u32(t01.val[0]),
+					      vget_high_u32(t23.val[0]));
+		uint32x4_t bo = vcombine_u32(vget_high_u32(t01.val[1]),
+					     vget_high_u32(t23.val[1]));
+
+		vst1q_u64(&m->addr[i],
+			  vcombine_u64(vget_low_u64(vreinterpretq_u64_u32(v0)),
+				       vget_low_u64(vreinterpretq_u64_u32(v1))));
+		vst1q_u64(&m->addr[i + 2],
+			  vcombine_u64(vget_low_u64(vreinterpretq_u64_u32(v2)),
+				       vget_low_u64(vreinterpretq_u64_u32(v3))));
+		vst1q_u32(&m->len[i], len);
+		vst1_u16(&m->bpid[i],
+			 vmovn_u32(vandq_u32(bo, vdupq_n_u32(QB_FD_BPID_MASK))));
+		vst1_u16(&m->offset[i],
+			 vmovn_u32(vandq_u32(vshrq_n_u32(bo, QB_FD_OFFSET_SHIFT),
+					     vdupq_n_u32(QB_FD_OFFSET_MASK))));
+
+		m->fqd_ctx[i] = dq[i]->dq.fqd_ctx;
+		m->fqd_ctx[i + 1] = dq[i + 1]->dq.fqd_ctx;
+		m->fqd_ctx[i + 2] = dq[i + 2]->dq.fqd_ctx;
+		m->fqd_ctx[i + 3] = dq[i + 3]->dq.fqd_ctx;
+		m->stat[i] = dq[i]->dq.stat;
+		m->stat[i + 1] = dq[i + 1]->dq.stat;
+		m->stat[i + 2] = dq[i + 2]->dq.stat;
+		m->stat[i + 3] = dq[i + 3]->dq.stat;
+	}
+#endif
+	for (; i < num; i++) {
+		fd = __qbman_result_DQ_fd(dq[i]);
+		m->addr[i] = ((uint64_t)fd->simple.addr_hi << 32) |
+				fd->simple.addr_lo;
+		m->len[i] = fd->simple.len;
+		m->bpid[i] = fd->simple.bpid_offset & QB_FD_BPID_MASK;
+		m->offset[i] = (fd->simple.bpid_offset >> QB_FD_OFFSET_SHIFT) &
+				QB_FD_OFFSET_MASK;
+		m->fqd_ctx[i] = dq[i]->dq.fqd_ctx;
+		m->stat[i] = dq[i]->dq.stat;
+	}
+}
+
 /**************************************/
 /* Parsing state-change notifications */
 /**************************************/
@@ -1795,6 +2422,31 @@ uint64_t qbman_result_cgcu_icnt(const struct qbman_result *scn)
 	return qbman_result_SCN_ctx(scn);
 }
 
+/*********************/
+/* Enqueue responses */
+/*********************/
+
+const struct qbman_fd *
+qbman_result_eqresp_fd(const struct qbman_result *eqresp)
+{
+	return (const struct qbman_fd *)&eqresp->eq_resp.fd[0];
+}
+
+void qbman_result_eqresp_set_rspid(struct qbman_result *eqresp, uint8_t val)
+{
+	eqresp->eq_resp.rspid = val;
+}
+
+uint8_t qbman_result_eqresp_rspid(const struct qbman_result *eqresp)
+{
+	return eqresp->eq_resp.rspid;
+}
+
+uint8_t qbman_result_eqresp_rc(const struct qbman_result *eqresp)
+{
+	return eqresp->eq_resp.rc;
+}
+
 /******************/
 /* Buffer release */
 /******************/
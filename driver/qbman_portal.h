@@ -115,6 +115,7 @@ struct qbman_swp {
 		uint32_t valid_bit;
 		uint8_t dqrr_size;
 		int reset_bug;
+		int prefetch; /* enum qbman_dqrr_prefetch_e */
 	} dqrr;
 	struct {
 		uint32_t pi;
@@ -123,7 +124,29 @@ struct qbman_swp {
 		uint32_t pi_ci_mask;
 		uint32_t ci;
 		int available;
+		int ci_thresh; /* refresh CI when available drops below this */
+		/* Deferred EQCR_PI doorbell (memory-backed mode only) */
+		uint32_t db_pending;
+		uint32_t db_thresh; /* 0 to ring on every enqueue call */
+		uint64_t db_budget;
+		uint64_t db_deadline;
 	} eqcr;
+	/* Software backlog for frames the EQCR could not take. 'head' and
+	 * 'tail' are free-running, 'size' is a power of 2 (0 if disabled).
+	 */
+	struct {
+		struct qbman_eq_desc *desc;
+		struct qbman_fd *fd;
+		uint32_t size;
+		uint32_t head;
+		uint32_t tail;
+	} eq_backlog;
+	/* Frame data/context prefetch on DQRR harvest */
+	struct {
+		uint32_t flags; /* QBMAN_PREFETCH_*, 0 if disabled */
+		uint32_t distance;
+		qbman_iova_to_va_cb iova2va; /* NULL for identity mapping */
+	} fd_prefetch;
 };
 
 /* -------------------------- */
@@ -157,6 +180,95 @@ static inline void *qbman_swp_mc_complete(struct qbman_swp *swp, void *cmd,
 	return cmd;
 }
 
+/* ---------------- */
+/* Enqueue commands */
+/* ---------------- */
+
+#define QB_ENQUEUE_CMD_OPTIONS_SHIFT    0
+enum qb_enqueue_commands {
+	enqueue_empty = 0,
+	enqueue_response_always = 1,
+	enqueue_rejects_to_fq = 2
+};
+
+#define QB_ENQUEUE_CMD_EC_OPTION_MASK		0x3
+#define QB_ENQUEUE_CMD_ORP_ENABLE_SHIFT		2
+#define QB_ENQUEUE_CMD_IRQ_ON_DISPATCH_SHIFT	3
+#define QB_ENQUEUE_CMD_TARGET_TYPE_SHIFT	4
+#define QB_ENQUEUE_CMD_DCA_PK_SHIFT		6
+#define QB_ENQUEUE_CMD_DCA_EN_SHIFT		7
+#define QB_ENQUEUE_CMD_NLIS_SHIFT		14
+#define QB_ENQUEUE_CMD_IS_NESN_SHIFT		15
+
+/* Have a response written whether the enqueue succeeds or not, keeping the
+ * rest of the descriptor as it is
+ */
+static inline void qbman_eq_desc_set_response_always(struct qbman_eq_desc *d)
+{
+	d->eq.verb &= ~QB_ENQUEUE_CMD_EC_OPTION_MASK;
+	d->eq.verb |= enqueue_response_always;
+}
+
+/* ----------------- */
+/* Frame descriptors */
+/* ----------------- */
+
+/* FD bpid_offset word: BPID in bits 0-13, IVP in bit 14, offset in bits 16-27
+ * and format in bits 28-29.
+ */
+#define QB_FD_BPID_MASK		0x3fff
+#define QB_FD_IVP		0x4000
+#define QB_FD_OFFSET_SHIFT	16
+#define QB_FD_OFFSET_MASK	0xfff
+#define QB_FD_FMT_SHIFT		28
+#define QB_FD_FMT_MASK		0x3
+#define QB_FD_FMT_SINGLE	0
+
+static inline uint16_t qbman_fd_get_bpid(const struct qbman_fd *fd)
+{
+	return fd->simple.bpid_offset & QB_FD_BPID_MASK;
+}
+
+static inline uint64_t qbman_fd_get_addr(const struct qbman_fd *fd)
+{
+	return ((uint64_t)fd->simple.addr_hi << 32) | fd->simple.addr_lo;
+}
+
+/* Whether the FD is a single buffer whose address can go back to its pool */
+static inline int qbman_fd_is_simple(const struct qbman_fd *fd)
+{
+	uint32_t bo = fd->simple.bpid_offset;
+
+	return ((bo >> QB_FD_FMT_SHIFT) & QB_FD_FMT_MASK) == QB_FD_FMT_SINGLE &&
+		!(bo & QB_FD_IVP);
+}
+
+/* Release up to 7 buffers to one pool */
+static inline int qbman_swp_release_bpid(struct qbman_swp *s, uint16_t bpid,
+					 const uint64_t *buffers,
+					 unsigned int num_buffers)
+{
+	struct qbman_release_desc rd;
+
+	qbman_release_desc_clear(&rd);
+	qbman_release_desc_set_bpid(&rd, bpid);
+	return qbman_swp_release(s, &rd, buffers, num_buffers);
+}
+
+/* Return the buffer of a single buffer FD to its pool. Returns -EINVAL if the
+ * FD is not one, or -EBUSY if the RCR can't take it yet.
+ */
+static inline int qbman_fd_release_simple(struct qbman_swp *s,
+					  const struct qbman_fd *fd)
+{
+	uint64_t buf;
+
+	if (!qbman_fd_is_simple(fd))
+		return -EINVAL;
+	buf = qbman_fd_get_addr(fd);
+	return qbman_swp_release_bpid(s, qbman_fd_get_bpid(fd), &buf, 1);
+}
+
 /* ---------------------- */
 /* Descriptors/cachelines */
 /* ---------------------- */
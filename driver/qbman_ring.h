@@ -0,0 +1,74 @@
+/* Copyright 2026 NXP
+ *
+ * SPDX-License-Identifier:        BSD-3-Clause
+ */
+
+#ifndef _QBMAN_RING_H_
+#define _QBMAN_RING_H_
+
+#include <string.h>
+#include "compat.h"
+
+/* Single-producer/single-consumer ring indices. The entries themselves live in
+ * arrays owned by the user of the ring, indexed with (index & (size - 1)), so
+ * each ring keeps its natural element type. 'head' and 'tail' are free-running
+ * and each side caches the other's index, only re-reading it when the cached
+ * value says the ring is full (or empty), so in steady state the producer and
+ * consumer cachelines are not bounced.
+ */
+struct qbman_spsc {
+	uint32_t size; /* power of 2 */
+	/* Producer side */
+	volatile uint32_t head __attribute__((aligned(64)));
+	uint32_t tail_cache;
+	/* Consumer side */
+	volatile uint32_t tail __attribute__((aligned(64)));
+	uint32_t head_cache;
+} __attribute__((aligned(64)));
+
+static inline void qbman_spsc_init(struct qbman_spsc *r, uint32_t size)
+{
+	memset(r, 0, sizeof(*r));
+	r->size = size;
+}
+
+/* Producer: free entries, re-reading 'tail' if fewer than 'want' */
+static inline uint32_t qbman_spsc_room(struct qbman_spsc *r, uint32_t want)
+{
+	uint32_t room = r->size - (r->head - r->tail_cache);
+
+	if (room < want) {
+		r->tail_cache = r->tail;
+		room = r->size - (r->head - r->tail_cache);
+	}
+	return room;
+}
+
+/* Producer: publish 'n' entries written from index 'head' on */
+static inline void qbman_spsc_produce(struct qbman_spsc *r, uint32_t n)
+{
+	smp_wmb();
+	r->head = r->head + n;
+}
+
+/* Consumer: pending entries, re-reading 'head' if fewer than 'want' */
+static inline uint32_t qbman_spsc_avail(struct qbman_spsc *r, uint32_t want)
+{
+	uint32_t avail = r->head_cache - r->tail;
+
+	if (avail < want) {
+		r->head_cache = r->head;
+		smp_rmb();
+		avail = r->head_cache - r->tail;
+	}
+	return avail;
+}
+
+/* Consumer: hand 'n' entries from index 'tail' on back to the producer */
+static inline void qbman_spsc_consume(struct qbman_spsc *r, uint32_t n)
+{
+	smp_mb();
+	r->tail = r->tail + n;
+}
+
+#endif /* _QBMAN_RING_H_ */
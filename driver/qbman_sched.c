@@ -0,0 +1,783 @@
+/* Copyright 2026 NXP
+ *
+ * SPDX-License-Identifier:        BSD-3-Clause
+ */
+
+#include "compat.h"
+#include <fsl_qbman_sched.h>
+#include <fsl_qbman_debug.h>
+#include "qbman_portal.h"
+
+/**************************/
+/* Push (SDQCR) scheduler */
+/**************************/
+
+#define QBMAN_PUSH_CHANNELS 16
+
+struct qbman_push_sched_chan {
+	uint16_t chanid;
+	uint8_t prio;
+	uint8_t managed;
+	uint32_t backlog;
+	uint32_t starved; /* runs spent disabled with a backlog */
+	uint32_t max_starve;
+};
+
+struct qbman_push_sched {
+	struct qbman_swp *swp;
+	uint16_t managed; /* mask of the managed channel indices */
+	struct qbman_push_sched_chan chan[QBMAN_PUSH_CHANNELS];
+};
+
+struct qbman_push_sched *qbman_push_sched_create(struct qbman_swp *s)
+{
+	struct qbman_push_sched *ps = malloc(sizeof(*ps));
+
+	if (!ps)
+		return NULL;
+
+	memset(ps, 0, sizeof(*ps));
+	ps->swp = s;
+	return ps;
+}
+
+void qbman_push_sched_destroy(struct qbman_push_sched *ps)
+{
+	free(ps);
+}
+
+int qbman_push_sched_add(struct qbman_push_sched *ps, uint8_t channel_idx,
+			 uint16_t chanid, uint8_t prio, uint32_t max_starve)
+{
+	struct qbman_push_sched_chan *c;
+
+	if (channel_idx >= QBMAN_PUSH_CHANNELS ||
+	    prio > QBMAN_PUSH_SCHED_PRIO_MAX)
+		return -EINVAL;
+
+	c = &ps->chan[channel_idx];
+	memset(c, 0, sizeof(*c));
+	c->chanid = chanid;
+	c->prio = prio;
+	c->max_starve = max_starve;
+	c->managed = 1;
+	ps->managed |= 1 << channel_idx;
+	return 0;
+}
+
+int qbman_push_sched_remove(struct qbman_push_sched *ps, uint8_t channel_idx)
+{
+	if (channel_idx >= QBMAN_PUSH_CHANNELS ||
+	    !ps->chan[channel_idx].managed)
+		return -EINVAL;
+
+	ps->chan[channel_idx].managed = 0;
+	ps->managed &= ~(1 << channel_idx);
+	return 0;
+}
+
+void qbman_push_sched_set_backlog(struct qbman_push_sched *ps,
+				  uint8_t channel_idx, uint32_t frames)
+{
+	QBMAN_BUG_ON(channel_idx >= QBMAN_PUSH_CHANNELS);
+	ps->chan[channel_idx].backlog = frames;
+}
+
+int qbman_push_sched_refresh(struct qbman_push_sched *ps)
+{
+	struct qbman_wqchan_query_rslt r;
+	struct qbman_push_sched_chan *c;
+	uint32_t frames;
+	int i, wq, ret;
+
+	for (i = 0; i < QBMAN_PUSH_CHANNELS; i++) {
+		c = &ps->chan[i];
+		if (!c->managed)
+			continue;
+		ret = qbman_wqchan_query(ps->swp, c->chanid, &r);
+		if (ret)
+			return ret;
+		frames = 0;
+		for (wq = 0; wq < 8; wq++)
+			frames += qbman_wqchan_attr_get_wqlen(&r, wq);
+		c->backlog = frames;
+	}
+	return 0;
+}
+
+uint16_t qbman_push_sched_run(struct qbman_push_sched *ps)
+{
+	struct qbman_push_sched_chan *c;
+	uint16_t old = qbman_swp_push_get_mask(ps->swp);
+	uint16_t mask = old & ~ps->managed;
+	int top = QBMAN_PUSH_SCHED_PRIO_MAX;
+	int i;
+
+	/* The highest priority with frames waiting; everything is enabled if
+	 * nothing is backlogged.
+	 */
+	for (i = 0; i < QBMAN_PUSH_CHANNELS; i++) {
+		c = &ps->chan[i];
+		if (c->managed && c->backlog && c->prio < top)
+			top = c->prio;
+	}
+
+	for (i = 0; i < QBMAN_PUSH_CHANNELS; i++) {
+		c = &ps->chan[i];
+		if (!c->managed)
+			continue;
+		if (c->prio <= top) {
+			mask |= 1 << i;
+			c->starved = 0;
+		} else if (!c->backlog) {
+			c->starved = 0;
+		} else if (c->starved >= c->max_starve) {
+			/* Held off long enough, let it run until the next pass */
+			mask |= 1 << i;
+			c->starved = 0;
+		} else {
+			c->starved++;
+		}
+	}
+
+	if (mask != old)
+		qbman_swp_push_set_mask(ps->swp, mask);
+	return mask;
+}
+
+/************************/
+/* Adaptive pull sizing */
+/************************/
+
+#define QBMAN_PULL_MAX_FRAMES 16
+
+void qbman_pull_adapt_init(struct qbman_pull_adapt *a, uint8_t max_frames)
+{
+	QBMAN_BUG_ON(!max_frames || max_frames > QBMAN_PULL_MAX_FRAMES);
+	memset(a, 0, sizeof(*a));
+	a->numframes = 1;
+	a->max_frames = max_frames;
+}
+
+int qbman_pull_adapt_update(struct qbman_pull_adapt *a,
+			    const struct qbman_result *dq)
+{
+	uint8_t stat = qbman_result_DQ_flags(dq);
+	uint32_t n;
+
+	if (stat & QBMAN_DQ_STAT_VALIDFRAME)
+		a->got++;
+	if (!(stat & QBMAN_DQ_STAT_EXPIRED))
+		return 0;
+
+	n = a->got;
+	a->got = 0;
+	a->pulls++;
+	a->frames += n;
+	if (!n)
+		a->empty_pulls++;
+
+	if ((stat & QBMAN_DQ_STAT_FQEMPTY) ||
+	    ((stat & QBMAN_DQ_STAT_VALIDFRAME) &&
+	     !qbman_result_DQ_frame_count(dq))) {
+		/* Drained: ask for what was there last time */
+		if (!n)
+			n = 1;
+		if (n < a->numframes) {
+			a->numframes = n;
+			a->shrinks++;
+		}
+	} else if (n >= a->numframes && a->numframes < a->max_frames) {
+		/* Full pull and more waiting */
+		n = a->numframes * 2;
+		a->numframes = n > a->max_frames ? a->max_frames : n;
+		a->grows++;
+	}
+	return 1;
+}
+
+/*****************************************/
+/* Deficit round robin volatile dequeues */
+/*****************************************/
+
+struct qbman_pull_sched_fq {
+	uint32_t fqid;
+	uint32_t quantum; /* 0 if the slot is free */
+	int64_t deficit;
+	uint32_t idle_until; /* round an empty FQ is pulled again */
+	uint8_t empty;
+	struct qbman_pull_adapt adapt;
+};
+
+struct qbman_pull_sched {
+	struct qbman_swp *swp;
+	struct qbman_pull_sched_fq *fq;
+	uint32_t size;
+	uint32_t cur;
+	uint32_t round;
+	uint32_t quantum;
+	uint32_t idle_rounds;
+	int inflight; /* FQ of the outstanding pull, -1 if none */
+};
+
+struct qbman_pull_sched *qbman_pull_sched_create(struct qbman_swp *s,
+						 uint32_t max_fqs,
+						 uint32_t quantum,
+						 uint32_t idle_rounds)
+{
+	struct qbman_pull_sched *ps;
+
+	if (!max_fqs || !quantum)
+		return NULL;
+
+	ps = malloc(sizeof(*ps));
+	if (!ps)
+		return NULL;
+
+	memset(ps, 0, sizeof(*ps));
+	ps->fq = calloc(max_fqs, sizeof(*ps->fq));
+	if (!ps->fq) {
+		pr_err("qbman_pull_sched: no memory for %u FQs\n", max_fqs);
+		free(ps);
+		return NULL;
+	}
+	ps->swp = s;
+	ps->size = max_fqs;
+	ps->quantum = quantum;
+	ps->idle_rounds = idle_rounds;
+	ps->inflight = -1;
+	return ps;
+}
+
+void qbman_pull_sched_destroy(struct qbman_pull_sched *ps)
+{
+	if (!ps)
+		return;
+	free(ps->fq);
+	free(ps);
+}
+
+int qbman_pull_sched_add(struct qbman_pull_sched *ps, uint32_t fqid,
+			 uint32_t weight)
+{
+	struct qbman_pull_sched_fq *fq;
+	uint32_t i;
+
+	if (!weight)
+		return -EINVAL;
+
+	for (i = 0; i < ps->size; i++) {
+		fq = &ps->fq[i];
+		if (fq->quantum)
+			continue;
+		memset(fq, 0, sizeof(*fq));
+		fq->fqid = fqid;
+		fq->quantum = weight * ps->quantum;
+		qbman_pull_adapt_init(&fq->adapt, QBMAN_PULL_MAX_FRAMES);
+		return i;
+	}
+	return -ENOSPC;
+}
+
+int qbman_pull_sched_remove(struct qbman_pull_sched *ps, int handle)
+{
+	if (handle < 0 || (uint32_t)handle >= ps->size ||
+	    !ps->fq[handle].quantum)
+		return -EINVAL;
+
+	ps->fq[handle].quantum = 0;
+	return 0;
+}
+
+int qbman_pull_sched_set_max_frames(struct qbman_pull_sched *ps, int handle,
+				    uint8_t max_frames)
+{
+	struct qbman_pull_adapt *a;
+
+	if (handle < 0 || (uint32_t)handle >= ps->size ||
+	    !ps->fq[handle].quantum ||
+	    !max_frames || max_frames > QBMAN_PULL_MAX_FRAMES)
+		return -EINVAL;
+
+	a = &ps->fq[handle].adapt;
+	a->max_frames = max_frames;
+	if (a->numframes > max_frames)
+		a->numframes = max_frames;
+	return 0;
+}
+
+const struct qbman_pull_adapt *qbman_pull_sched_adapt(
+			const struct qbman_pull_sched *ps, int handle)
+{
+	QBMAN_BUG_ON(handle < 0 || (uint32_t)handle >= ps->size);
+	return &ps->fq[handle].adapt;
+}
+
+void qbman_pull_sched_wake(struct qbman_pull_sched *ps, int handle)
+{
+	QBMAN_BUG_ON(handle < 0 || (uint32_t)handle >= ps->size);
+	ps->fq[handle].empty = 0;
+}
+
+static inline int qbman_pull_sched_eligible(const struct qbman_pull_sched *ps,
+					    const struct qbman_pull_sched_fq *fq)
+{
+	return fq->quantum &&
+		(!fq->empty || (int32_t)(ps->round - fq->idle_until) >= 0);
+}
+
+/* Keep serving the current FQ while it has credit, otherwise move on and give
+ * the next eligible FQ its quantum. The credit is granted on the visit, so a
+ * pull refused by the portal just gets retried on the same FQ.
+ */
+static int qbman_pull_sched_pick(struct qbman_pull_sched *ps)
+{
+	struct qbman_pull_sched_fq *fq = &ps->fq[ps->cur];
+	uint64_t r, rounds = UINT64_MAX;
+	uint32_t n;
+
+	if (qbman_pull_sched_eligible(ps, fq) && fq->deficit > 0)
+		return ps->cur;
+
+	for (n = 0; n < ps->size; n++) {
+		if (++ps->cur == ps->size) {
+			ps->cur = 0;
+			ps->round++;
+		}
+		fq = &ps->fq[ps->cur];
+		if (!qbman_pull_sched_eligible(ps, fq))
+			continue;
+		fq->deficit += fq->quantum;
+		if (fq->deficit > 0)
+			return ps->cur;
+	}
+
+	/* A whole round left every eligible FQ without credit, because pulls
+	 * cost more than a quantum. Grant at once the rounds it takes for the
+	 * first FQ to get credit back, rather than letting the VDQCR pipeline
+	 * go idle while FQs have backlog. The round count moves on by as many,
+	 * so idle FQs come back when they would have one round at a time.
+	 */
+	for (n = 0; n < ps->size; n++) {
+		fq = &ps->fq[n];
+		if (!qbman_pull_sched_eligible(ps, fq))
+			continue;
+		r = (uint64_t)(-fq->deficit) / fq->quantum + 1;
+		if (r < rounds)
+			rounds = r;
+	}
+	if (rounds == UINT64_MAX)
+		return -1;
+
+	for (n = 0; n < ps->size; n++) {
+		fq = &ps->fq[n];
+		if (qbman_pull_sched_eligible(ps, fq))
+			fq->deficit += (int64_t)(rounds * fq->quantum);
+	}
+	ps->round += (uint32_t)rounds;
+	for (n = 0; n < ps->size; n++) {
+		if (++ps->cur == ps->size)
+			ps->cur = 0;
+		fq = &ps->fq[ps->cur];
+		if (qbman_pull_sched_eligible(ps, fq) && fq->deficit > 0)
+			return ps->cur;
+	}
+	return -1;
+}
+
+int qbman_pull_sched_issue(struct qbman_pull_sched *ps)
+{
+	struct qbman_pull_desc pd;
+	struct qbman_pull_sched_fq *fq;
+	int idx;
+
+	if (ps->inflight >= 0)
+		return 0;
+
+	idx = qbman_pull_sched_pick(ps);
+	if (idx < 0)
+		return 0;
+
+	fq = &ps->fq[idx];
+	qbman_pull_desc_clear(&pd);
+	qbman_pull_desc_set_numframes(&pd, fq->adapt.numframes);
+	qbman_pull_desc_set_fq(&pd, fq->fqid);
+	if (qbman_swp_pull(ps->swp, &pd))
+		return 0;
+
+	ps->inflight = idx;
+	return 1;
+}
+
+void qbman_pull_sched_account(struct qbman_pull_sched *ps,
+			      const struct qbman_result *dq)
+{
+	struct qbman_pull_sched_fq *fq;
+	uint8_t stat;
+
+	if (ps->inflight < 0 || !qbman_result_is_DQ(dq))
+		return;
+
+	stat = qbman_result_DQ_flags(dq);
+	if (!(stat & QBMAN_DQ_STAT_VOLATILE))
+		return;
+
+	fq = &ps->fq[ps->inflight];
+	if (fq->quantum && qbman_result_DQ_fqid(dq) == fq->fqid) {
+		qbman_pull_adapt_update(&fq->adapt, dq);
+		if (stat & QBMAN_DQ_STAT_VALIDFRAME)
+			fq->deficit -= qbman_result_DQ_fd(dq)->simple.len;
+		/* An empty FQ leaves the round and loses its credit */
+		if ((stat & QBMAN_DQ_STAT_FQEMPTY) ||
+		    ((stat & QBMAN_DQ_STAT_VALIDFRAME) &&
+		     !qbman_result_DQ_byte_count(dq))) {
+			fq->empty = 1;
+			fq->deficit = 0;
+			fq->idle_until = ps->round + ps->idle_rounds;
+		}
+	}
+
+	if (stat & QBMAN_DQ_STAT_EXPIRED) {
+		ps->inflight = -1;
+		qbman_pull_sched_issue(ps);
+	}
+}
+
+/***************************************/
+/* Work stealing across worker portals */
+/***************************************/
+
+struct qbman_steal_fq {
+	uint32_t fqid;
+	uint32_t flags;
+	atomic_t backlog; /* frames, as last published */
+	atomic_t held; /* last seen held active */
+	atomic_t claimed; /* a thief has a pull outstanding */
+};
+
+struct qbman_steal_worker {
+	struct qbman_swp *swp;
+	struct qbman_steal_fq *fq;
+	uint32_t num_fqs;
+	struct qbman_steal_fq *stolen; /* target of our outstanding pull */
+};
+
+struct qbman_steal_group {
+	struct qbman_steal_worker *w;
+	struct qbman_steal_fq *fqs;
+	uint32_t max_workers;
+	uint32_t max_fqs;
+	uint32_t num_workers;
+	uint32_t min_backlog;
+};
+
+struct qbman_steal_group *qbman_steal_group_create(uint32_t max_workers,
+						   uint32_t max_fqs,
+						   uint32_t min_backlog)
+{
+	struct qbman_steal_group *sg;
+
+	if (!max_workers || !max_fqs)
+		return NULL;
+
+	sg = malloc(sizeof(*sg));
+	if (!sg)
+		return NULL;
+
+	memset(sg, 0, sizeof(*sg));
+	sg->w = calloc(max_workers, sizeof(*sg->w));
+	sg->fqs = calloc(max_workers * max_fqs, sizeof(*sg->fqs));
+	if (!sg->w || !sg->fqs) {
+		pr_err("qbman_steal: no memory for %u workers\n", max_workers);
+		free(sg->w);
+		free(sg->fqs);
+		free(sg);
+		return NULL;
+	}
+	sg->max_workers = max_workers;
+	sg->max_fqs = max_fqs;
+	sg->min_backlog = min_backlog ? min_backlog : 1;
+	return sg;
+}
+
+void qbman_steal_group_destroy(struct qbman_steal_group *sg)
+{
+	if (!sg)
+		return;
+	free(sg->w);
+	free(sg->fqs);
+	free(sg);
+}
+
+int qbman_steal_worker_add(struct qbman_steal_group *sg, struct qbman_swp *s)
+{
+	struct qbman_steal_worker *w;
+
+	if (sg->num_workers == sg->max_workers)
+		return -ENOSPC;
+
+	w = &sg->w[sg->num_workers];
+	w->swp = s;
+	w->fq = &sg->fqs[sg->num_workers * sg->max_fqs];
+	return sg->num_workers++;
+}
+
+int qbman_steal_fq_add(struct qbman_steal_group *sg, int worker, uint32_t fqid,
+		       uint32_t flags)
+{
+	struct qbman_steal_worker *w;
+	struct qbman_steal_fq *fq;
+
+	if (worker < 0 || (uint32_t)worker >= sg->num_workers)
+		return -EINVAL;
+
+	w = &sg->w[worker];
+	if (w->num_fqs == sg->max_fqs)
+		return -ENOSPC;
+
+	fq = &w->fq[w->num_fqs];
+	fq->fqid = fqid;
+	fq->flags = flags;
+	atomic_set(&fq->backlog, 0);
+	atomic_set(&fq->held, 0);
+	atomic_set(&fq->claimed, 0);
+	return w->num_fqs++;
+}
+
+void qbman_steal_set_backlog(struct qbman_steal_group *sg, int worker, int fq,
+			     uint32_t frames)
+{
+	QBMAN_BUG_ON((uint32_t)worker >= sg->num_workers ||
+		     (uint32_t)fq >= sg->w[worker].num_fqs);
+	atomic_set(&sg->w[worker].fq[fq].backlog, (int)frames);
+}
+
+int qbman_steal_refresh(struct qbman_steal_group *sg, int self, int worker)
+{
+	struct qbman_fq_query_np_rslt r;
+	struct qbman_steal_worker *w;
+	struct qbman_steal_fq *fq;
+	uint32_t i;
+	int ret;
+
+	if ((uint32_t)self >= sg->num_workers ||
+	    (uint32_t)worker >= sg->num_workers)
+		return -EINVAL;
+
+	w = &sg->w[worker];
+	for (i = 0; i < w->num_fqs; i++) {
+		fq = &w->fq[i];
+		ret = qbman_fq_query_state(sg->w[self].swp, fq->fqid, &r);
+		if (ret)
+			return ret;
+		atomic_set(&fq->backlog, (int)qbman_fq_state_frame_count(&r));
+		atomic_set(&fq->held, qbman_fq_state_schedstate(&r) ==
+			   qbman_fq_schedstate_held_active);
+	}
+	return 0;
+}
+
+/* The most backlogged stealable FQ of the other workers, NULL if none is
+ * worth it.
+ */
+static struct qbman_steal_fq *qbman_steal_pick(struct qbman_steal_group *sg,
+					       uint32_t self, int *seen)
+{
+	struct qbman_steal_fq *best = NULL, *fq;
+	int best_backlog = (int)sg->min_backlog - 1;
+	int backlog;
+	uint32_t i, j;
+
+	for (i = 0; i < sg->num_workers; i++) {
+		if (i == self)
+			continue;
+		for (j = 0; j < sg->w[i].num_fqs; j++) {
+			fq = &sg->w[i].fq[j];
+			if ((fq->flags & QBMAN_STEAL_FQ_ORDERED) ||
+			    atomic_read(&fq->held) || atomic_read(&fq->claimed))
+				continue;
+			backlog = atomic_read(&fq->backlog);
+			if (backlog > best_backlog) {
+				best = fq;
+				best_backlog = backlog;
+			}
+		}
+	}
+	*seen = best_backlog;
+	return best;
+}
+
+int qbman_steal(struct qbman_steal_group *sg, int self)
+{
+	struct qbman_steal_worker *w;
+	struct qbman_steal_fq *fq;
+	struct qbman_pull_desc pd;
+	int backlog;
+
+	QBMAN_BUG_ON((uint32_t)self >= sg->num_workers);
+	w = &sg->w[self];
+	if (w->stolen)
+		return 0;
+
+	fq = qbman_steal_pick(sg, self, &backlog);
+	if (!fq)
+		return 0;
+
+	/* Lost the race to another thief, or the owner drained the FQ since */
+	if (atomic_inc_return(&fq->claimed) != 1 ||
+	    !atomic_read(&fq->backlog)) {
+		atomic_dec(&fq->claimed);
+		return 0;
+	}
+
+	/* Size the pull from the backlog the FQ was picked for; numframes is
+	 * encoded minus one, so it must stay within 1..QBMAN_PULL_MAX_FRAMES.
+	 */
+	if (backlog < 1)
+		backlog = 1;
+	else if (backlog > QBMAN_PULL_MAX_FRAMES)
+		backlog = QBMAN_PULL_MAX_FRAMES;
+	qbman_pull_desc_clear(&pd);
+	qbman_pull_desc_set_numframes(&pd, backlog);
+	qbman_pull_desc_set_fq(&pd, fq->fqid);
+	if (qbman_swp_pull(w->swp, &pd)) {
+		atomic_dec(&fq->claimed);
+		return 0;
+	}
+
+	w->stolen = fq;
+	return 1;
+}
+
+void qbman_steal_account(struct qbman_steal_group *sg, int self,
+			 const struct qbman_result *dq)
+{
+	struct qbman_steal_worker *w = &sg->w[self];
+	struct qbman_steal_fq *fq = w->stolen;
+	uint8_t stat;
+
+	if (!fq || !qbman_result_is_DQ(dq) ||
+	    qbman_result_DQ_fqid(dq) != fq->fqid)
+		return;
+
+	stat = qbman_result_DQ_flags(dq);
+	if (!(stat & QBMAN_DQ_STAT_VOLATILE))
+		return;
+
+	if (stat & QBMAN_DQ_STAT_FQEMPTY)
+		atomic_set(&fq->backlog, 0);
+	else if (stat & QBMAN_DQ_STAT_VALIDFRAME)
+		atomic_set(&fq->backlog, (int)qbman_result_DQ_frame_count(dq));
+
+	if (stat & QBMAN_DQ_STAT_EXPIRED) {
+		w->stolen = NULL;
+		atomic_dec(&fq->claimed);
+	}
+}
+
+/************************/
+/* Multi-portal polling */
+/************************/
+
+struct qbman_poll_member {
+	struct qbman_swp *swp;
+	uint32_t burst_cap;
+};
+
+struct qbman_poll_group {
+	struct qbman_poll_member *m;
+	uint16_t *ready;
+	uint32_t size;
+	uint32_t num;
+	uint32_t next; /* member polled first next time */
+};
+
+struct qbman_poll_group *qbman_poll_group_create(uint32_t max_portals)
+{
+	struct qbman_poll_group *pg;
+
+	if (!max_portals || max_portals > UINT16_MAX)
+		return NULL;
+
+	pg = malloc(sizeof(*pg));
+	if (!pg)
+		return NULL;
+
+	memset(pg, 0, sizeof(*pg));
+	pg->m = calloc(max_portals, sizeof(*pg->m));
+	pg->ready = calloc(max_portals, sizeof(*pg->ready));
+	if (!pg->m || !pg->ready) {
+		pr_err("qbman_poll_group: no memory for %u portals\n",
+		       max_portals);
+		free(pg->m);
+		free(pg->ready);
+		free(pg);
+		return NULL;
+	}
+	pg->size = max_portals;
+	return pg;
+}
+
+void qbman_poll_group_destroy(struct qbman_poll_group *pg)
+{
+	if (!pg)
+		return;
+	free(pg->m);
+	free(pg->ready);
+	free(pg);
+}
+
+int qbman_poll_group_add(struct qbman_poll_group *pg, struct qbman_swp *s,
+			 uint32_t burst_cap)
+{
+	if (!burst_cap)
+		return -EINVAL;
+	if (pg->num == pg->size)
+		return -ENOSPC;
+
+	pg->m[pg->num].swp = s;
+	pg->m[pg->num].burst_cap = burst_cap;
+	return pg->num++;
+}
+
+struct qbman_swp *qbman_poll_group_swp(const struct qbman_poll_group *pg,
+				       uint16_t idx)
+{
+	QBMAN_BUG_ON(idx >= pg->num);
+	return pg->m[idx].swp;
+}
+
+int qbman_poll_group_poll(struct qbman_poll_group *pg,
+			  const struct qbman_result **dq, uint16_t *src,
+			  int num)
+{
+	struct qbman_poll_member *m;
+	uint32_t i, idx, nready = 0;
+	int n, cap, got = 0;
+
+	if (!pg->num)
+		return 0;
+
+	/* First pass: valid-bits only, in rotating order */
+	idx = pg->next;
+	for (i = 0; i < pg->num; i++) {
+		if (qbman_swp_dqrr_ready(pg->m[idx].swp))
+			pg->ready[nready++] = idx;
+		if (++idx == pg->num)
+			idx = 0;
+	}
+	if (++pg->next == pg->num)
+		pg->next = 0;
+
+	/* Second pass: harvest the ready members up to their caps */
+	for (i = 0; i < nready && got < num; i++) {
+		m = &pg->m[pg->ready[i]];
+		cap = num - got;
+		if ((uint32_t)cap > m->burst_cap)
+			cap = m->burst_cap;
+		n = qbman_swp_dqrr_next_burst(m->swp, &dq[got], cap);
+		while (n--)
+			src[got++] = pg->ready[i];
+	}
+	return got;
+}
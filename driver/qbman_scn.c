@@ -0,0 +1,292 @@
+/* Copyright 2026 NXP
+ *
+ * SPDX-License-Identifier:        BSD-3-Clause
+ */
+
+#include "compat.h"
+#include <fsl_qbman_scn.h>
+#include <fsl_qbman_debug.h>
+#include "qbman_portal.h"
+
+/***************************/
+/* CGR congestion tracking */
+/***************************/
+
+struct qbman_cgr_cache *qbman_cgr_cache_create(uint32_t num_cgids)
+{
+	struct qbman_cgr_cache *cc;
+	uint8_t *congested;
+
+	if (!num_cgids)
+		return NULL;
+
+	cc = malloc(sizeof(*cc));
+	if (!cc)
+		return NULL;
+
+	congested = calloc(num_cgids, sizeof(*congested));
+	if (!congested) {
+		pr_err("qbman_cgr_cache: no memory for %u CGRs\n", num_cgids);
+		free(cc);
+		return NULL;
+	}
+	cc->num_cgids = num_cgids;
+	cc->congested = congested;
+	return cc;
+}
+
+void qbman_cgr_cache_destroy(struct qbman_cgr_cache *cc)
+{
+	if (!cc)
+		return;
+	free((void *)(uintptr_t)cc->congested);
+	free(cc);
+}
+
+int qbman_cgr_cache_update(struct qbman_cgr_cache *cc,
+			   const struct qbman_result *scn)
+{
+	uint16_t cgid;
+
+	if (!qbman_result_is_CSCN(scn))
+		return 0;
+
+	cgid = qbman_result_CSCN_cgid(scn);
+	if (cgid >= cc->num_cgids)
+		return 0;
+
+	cc->congested[cgid] = qbman_result_SCN_state(scn) &
+				QBMAN_CSCN_STATE_CONGESTED;
+	return 1;
+}
+
+/***************************/
+/* Buffer pool state table */
+/***************************/
+
+#define QBMAN_BP_STATE_MASK \
+	(QBMAN_BP_STATE_EMPTY | QBMAN_BP_STATE_DEPLETED | QBMAN_BP_STATE_SURPLUS)
+
+struct qbman_bp_state *qbman_bp_state_create(uint32_t num_bpids,
+					     qbman_bp_state_cb cb, void *ctx)
+{
+	struct qbman_bp_state *bs;
+	uint8_t *state;
+
+	if (!num_bpids)
+		return NULL;
+
+	bs = malloc(sizeof(*bs));
+	if (!bs)
+		return NULL;
+
+	state = calloc(num_bpids, sizeof(*state));
+	if (!state) {
+		pr_err("qbman_bp_state: no memory for %u pools\n", num_bpids);
+		free(bs);
+		return NULL;
+	}
+	bs->num_bpids = num_bpids;
+	bs->state = state;
+	bs->cb = cb;
+	bs->ctx = ctx;
+	return bs;
+}
+
+void qbman_bp_state_destroy(struct qbman_bp_state *bs)
+{
+	if (!bs)
+		return;
+	free((void *)(uintptr_t)bs->state);
+	free(bs);
+}
+
+static void qbman_bp_state_set(struct qbman_bp_state *bs, uint16_t bpid,
+			       uint8_t state)
+{
+	uint8_t old = bs->state[bpid];
+
+	bs->state[bpid] = state;
+	if (bs->cb && ((old ^ state) & QBMAN_BP_STATE_DEPLETED))
+		bs->cb(bs->ctx, bpid, state);
+}
+
+int qbman_bp_state_update(struct qbman_bp_state *bs,
+			  const struct qbman_result *scn)
+{
+	uint16_t bpid;
+
+	if (!qbman_result_is_BPSCN(scn))
+		return 0;
+
+	bpid = qbman_result_bpscn_bpid(scn);
+	if (bpid >= bs->num_bpids)
+		return 0;
+
+	qbman_bp_state_set(bs, bpid,
+			   qbman_result_SCN_state(scn) & QBMAN_BP_STATE_MASK);
+	return 1;
+}
+
+int qbman_bp_state_sync(struct qbman_bp_state *bs, struct qbman_swp *s,
+			uint16_t bpid)
+{
+	struct qbman_bp_query_rslt r;
+	uint8_t state = 0;
+	int ret;
+
+	if (bpid >= bs->num_bpids)
+		return -EINVAL;
+
+	ret = qbman_bp_query(s, bpid, &r);
+	if (ret)
+		return ret;
+
+	if (!qbman_bp_has_free_bufs(&r))
+		state |= QBMAN_BP_STATE_EMPTY;
+	if (qbman_bp_is_depleted(&r))
+		state |= QBMAN_BP_STATE_DEPLETED;
+	if (qbman_bp_is_surplus(&r))
+		state |= QBMAN_BP_STATE_SURPLUS;
+	qbman_bp_state_set(bs, bpid, state);
+	return 0;
+}
+
+int qbman_swp_acquire_checked(struct qbman_swp *s,
+			      const struct qbman_bp_state *bs, uint16_t bpid,
+			      uint64_t *buffers, unsigned int num_buffers)
+{
+	if (!qbman_bp_has_bufs(bs, bpid))
+		return -ENOBUFS;
+
+	return qbman_swp_acquire(s, bpid, buffers, num_buffers);
+}
+
+/****************************/
+/* Software WRED early drop */
+/****************************/
+
+#define QBMAN_CGR_CNT_MASK 0xFFFFFFFFFFllu
+
+struct qbman_wred_shadow *qbman_wred_shadow_create(uint32_t num_cgids)
+{
+	struct qbman_wred_shadow *ws;
+
+	if (!num_cgids)
+		return NULL;
+
+	ws = malloc(sizeof(*ws));
+	if (!ws)
+		return NULL;
+
+	ws->cgr = calloc(num_cgids, sizeof(*ws->cgr));
+	if (!ws->cgr) {
+		pr_err("qbman_wred_shadow: no memory for %u CGRs\n",
+		       num_cgids);
+		free(ws);
+		return NULL;
+	}
+	ws->num_cgids = num_cgids;
+	return ws;
+}
+
+void qbman_wred_shadow_destroy(struct qbman_wred_shadow *ws)
+{
+	uint32_t i;
+
+	if (!ws)
+		return;
+	for (i = 0; i < ws->num_cgids; i++)
+		free(ws->cgr[i]);
+	free(ws->cgr);
+	free(ws);
+}
+
+static void qbman_wred_dp_init(struct qbman_wred_dp *dp, int enabled,
+			       uint32_t parm)
+{
+	uint64_t minth, maxth;
+	uint8_t maxp;
+
+	dp->minth = UINT64_MAX;
+	dp->maxth = UINT64_MAX;
+	dp->range = 0;
+	dp->maxp = 0;
+	if (!enabled)
+		return;
+
+	qbman_cgr_attr_wred_dp_decompose(parm, &minth, &maxth, &maxp);
+	dp->minth = minth;
+	dp->maxth = maxth;
+	if (maxth > minth)
+		dp->range = maxth - minth;
+	dp->maxp = ((uint64_t)maxp << 32) / 100;
+}
+
+int qbman_wred_shadow_load(struct qbman_wred_shadow *ws, struct qbman_swp *s,
+			   uint16_t cgid)
+{
+	struct qbman_wred_query_rslt wr;
+	struct qbman_cgr_query_rslt cr;
+	struct qbman_wred_cgr *c;
+	uint32_t i;
+	int ret;
+
+	if (cgid >= ws->num_cgids)
+		return -EINVAL;
+
+	ret = qbman_cgr_wred_query(s, cgid, &wr);
+	if (ret)
+		return ret;
+	ret = qbman_cgr_query(s, cgid, &cr);
+	if (ret)
+		return ret;
+
+	c = ws->cgr[cgid];
+	if (!c) {
+		c = malloc(sizeof(*c));
+		if (!c)
+			return -ENOMEM;
+	}
+	for (i = 0; i < QBMAN_WRED_DP_NUM; i++)
+		qbman_wred_dp_init(&c->dp[i],
+				   qbman_cgr_attr_wred_get_edp(&wr, i),
+				   qbman_cgr_attr_wred_get_parm_dp(&wr, i));
+	c->count = cr.i_cnt & QBMAN_CGR_CNT_MASK;
+	ws->cgr[cgid] = c;
+	return 0;
+}
+
+int qbman_wred_shadow_refresh(struct qbman_wred_shadow *ws,
+			      struct qbman_swp *s, uint16_t cgid)
+{
+	struct qbman_cgr_query_rslt cr;
+	int ret;
+
+	if (cgid >= ws->num_cgids || !ws->cgr[cgid])
+		return -EINVAL;
+
+	ret = qbman_cgr_query(s, cgid, &cr);
+	if (ret)
+		return ret;
+
+	ws->cgr[cgid]->count = cr.i_cnt & QBMAN_CGR_CNT_MASK;
+	return 0;
+}
+
+int qbman_wred_shadow_update(struct qbman_wred_shadow *ws,
+			     const struct qbman_result *scn)
+{
+	uint16_t cgid;
+
+	if (!qbman_result_is_CGCU(scn))
+		return 0;
+
+	cgid = qbman_result_cgcu_cgid(scn);
+	if (cgid >= ws->num_cgids || !ws->cgr[cgid])
+		return 0;
+
+	ws->cgr[cgid]->count = qbman_result_cgcu_icnt(scn) &
+				QBMAN_CGR_CNT_MASK;
+	return 1;
+}
@@ -0,0 +1,255 @@
+/* Copyright 2026 NXP
+ *
+ * SPDX-License-Identifier:        BSD-3-Clause
+ */
+
+#include "compat.h"
+#include <fsl_qbman_shaper.h>
+#include "qbman_portal.h"
+
+/* Token counts and rates are 32.32 fixed point bytes, rates per counter tick */
+#define QBMAN_SHAPER_FP_SHIFT 32
+
+struct qbman_shaper_tgt {
+	uint64_t rate;
+	uint64_t burst;
+	uint64_t tokens;
+	uint64_t fill_ticks; /* ticks to refill an empty bucket */
+	uint64_t last; /* tick of the last refill */
+	uint64_t next; /* tick at which the head deferred frame fits */
+	/* Deferred frames */
+	uint32_t head;
+	uint32_t tail;
+	struct qbman_eq_desc *desc;
+	struct qbman_fd *fd;
+};
+
+struct qbman_shaper {
+	struct qbman_swp *swp;
+	uint64_t hz;
+	uint32_t max_targets;
+	uint32_t num_targets;
+	uint32_t queue_size;
+	uint32_t deferred; /* total over all targets */
+	struct qbman_shaper_tgt *tgt;
+};
+
+struct qbman_shaper *qbman_shaper_create(struct qbman_swp *s,
+					 uint32_t max_targets,
+					 uint32_t queue_size)
+{
+	struct qbman_shaper *sh;
+
+	if (!max_targets || !queue_size || (queue_size & (queue_size - 1))) {
+		pr_err("qbman_shaper: bad size %u/%u\n", max_targets,
+		       queue_size);
+		return NULL;
+	}
+
+	sh = malloc(sizeof(*sh));
+	if (!sh)
+		return NULL;
+
+	sh->hz = read_free_running_frequency();
+	if (!sh->hz) {
+		pr_err("qbman_shaper: counter frequency unknown\n");
+		free(sh);
+		return NULL;
+	}
+
+	sh->tgt = calloc(max_targets, sizeof(*sh->tgt));
+	if (!sh->tgt) {
+		free(sh);
+		return NULL;
+	}
+	sh->swp = s;
+	sh->max_targets = max_targets;
+	sh->num_targets = 0;
+	sh->queue_size = queue_size;
+	sh->deferred = 0;
+	return sh;
+}
+
+void qbman_shaper_destroy(struct qbman_shaper *sh)
+{
+	uint32_t i;
+
+	if (!sh)
+		return;
+	for (i = 0; i < sh->num_targets; i++) {
+		free(sh->tgt[i].desc);
+		free(sh->tgt[i].fd);
+	}
+	free(sh->tgt);
+	free(sh);
+}
+
+int qbman_shaper_target_add(struct qbman_shaper *sh, uint64_t rate,
+			    uint32_t burst)
+{
+	struct qbman_shaper_tgt *t;
+
+	if (!rate || !burst)
+		return -EINVAL;
+	if (sh->num_targets == sh->max_targets)
+		return -ENOSPC;
+
+	t = &sh->tgt[sh->num_targets];
+	t->desc = malloc(sh->queue_size * sizeof(*t->desc));
+	t->fd = malloc(sh->queue_size * sizeof(*t->fd));
+	if (!t->desc || !t->fd) {
+		free(t->desc);
+		free(t->fd);
+		return -ENOMEM;
+	}
+
+	/* Split so that the shift can't overflow for any realistic rate */
+	t->rate = ((rate / sh->hz) << QBMAN_SHAPER_FP_SHIFT) +
+		  (((rate % sh->hz) << QBMAN_SHAPER_FP_SHIFT) / sh->hz);
+	if (!t->rate)
+		t->rate = 1;
+	t->burst = (uint64_t)burst << QBMAN_SHAPER_FP_SHIFT;
+	t->tokens = t->burst;
+	t->fill_ticks = t->burst / t->rate + 1;
+	t->last = read_free_running_frequency_counter();
+	t->next = 0;
+	t->head = 0;
+	t->tail = 0;
+	return sh->num_targets++;
+}
+
+static void qbman_shaper_refill(struct qbman_shaper_tgt *t, uint64_t now)
+{
+	uint64_t elapsed = now - t->last;
+
+	t->last = now;
+	if (elapsed >= t->fill_ticks) {
+		t->tokens = t->burst;
+		return;
+	}
+	t->tokens += elapsed * t->rate;
+	if (t->tokens > t->burst)
+		t->tokens = t->burst;
+}
+
+static inline uint64_t qbman_shaper_cost(const struct qbman_fd *fd)
+{
+	return (uint64_t)fd->simple.len << QBMAN_SHAPER_FP_SHIFT;
+}
+
+/* Work out when the head deferred frame fits in the bucket */
+static void qbman_shaper_schedule(struct qbman_shaper_tgt *t, uint32_t mask)
+{
+	uint64_t cost = qbman_shaper_cost(&t->fd[t->head & mask]);
+
+	if (cost <= t->tokens)
+		t->next = t->last;
+	else
+		t->next = t->last + (cost - t->tokens) / t->rate + 1;
+}
+
+int qbman_shaper_enqueue(struct qbman_shaper *sh, int target,
+			 const struct qbman_eq_desc *d,
+			 const struct qbman_fd *fd, int num)
+{
+	struct qbman_shaper_tgt *t = &sh->tgt[target];
+	uint32_t mask = sh->queue_size - 1;
+	uint64_t cost;
+	int i, n = 0, sent = 0;
+
+	/* A frame longer than the bucket would never become eligible and would
+	 * block the target for good, so it and what follows are not accepted.
+	 */
+	for (i = 0; i < num; i++)
+		if (qbman_shaper_cost(&fd[i]) > t->burst)
+			break;
+	num = i;
+	if (!num)
+		return 0;
+
+	qbman_shaper_refill(t, read_free_running_frequency_counter());
+
+	/* Nothing overtakes frames already deferred */
+	if (t->head == t->tail) {
+		while (n < num) {
+			cost = qbman_shaper_cost(&fd[n]);
+			if (cost > t->tokens)
+				break;
+			t->tokens -= cost;
+			n++;
+		}
+	}
+	if (n) {
+		sent = qbman_swp_enqueue_multiple(sh->swp, d, fd, NULL, n);
+		if (sent < 0)
+			sent = 0;
+		for (i = sent; i < n; i++)
+			t->tokens += qbman_shaper_cost(&fd[i]);
+	}
+	if (sent == num)
+		return sent;
+
+	for (i = sent; i < num && t->tail - t->head < sh->queue_size; i++) {
+		t->desc[t->tail & mask] = *d;
+		t->fd[t->tail & mask] = fd[i];
+		t->tail++;
+		sh->deferred++;
+	}
+	if (t->head != t->tail)
+		qbman_shaper_schedule(t, mask);
+	return i;
+}
+
+int qbman_shaper_service(struct qbman_shaper *sh)
+{
+	struct qbman_shaper_tgt *t;
+	uint32_t mask = sh->queue_size - 1;
+	uint32_t i, idx, n, contig;
+	uint64_t now, cost;
+	int sent, total = 0;
+
+	if (!sh->deferred)
+		return 0;
+
+	now = read_free_running_frequency_counter();
+	for (i = 0; i < sh->num_targets; i++) {
+		t = &sh->tgt[i];
+		if (t->head == t->tail || (int64_t)(now - t->next) < 0)
+			continue;
+
+		qbman_shaper_refill(t, now);
+		idx = t->head & mask;
+		contig = sh->queue_size - idx;
+		if (contig > t->tail - t->head)
+			contig = t->tail - t->head;
+		for (n = 0; n < contig; n++) {
+			cost = qbman_shaper_cost(&t->fd[idx + n]);
+			if (cost > t->tokens)
+				break;
+			t->tokens -= cost;
+		}
+		if (!n) {
+			qbman_shaper_schedule(t, mask);
+			continue;
+		}
+
+		sent = qbman_swp_enqueue_multiple_desc(sh->swp, &t->desc[idx],
+						       &t->fd[idx], n);
+		if (sent < 0)
+			sent = 0;
+		for (; n > (uint32_t)sent; n--)
+			t->tokens += qbman_shaper_cost(&t->fd[idx + n - 1]);
+
+		t->head += sent;
+		sh->deferred -= sent;
+		total += sent;
+		if (t->head != t->tail)
+			qbman_shaper_schedule(t, mask);
+	}
+	return total;
+}
+
+uint32_t qbman_shaper_deferred(const struct qbman_shaper *sh, int target)
+{
+	return sh->tgt[target].tail - sh->tgt[target].head;
+}
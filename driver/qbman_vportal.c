@@ -0,0 +1,508 @@
+/* Copyright 2026 NXP
+ *
+ * SPDX-License-Identifier:        BSD-3-Clause
+ */
+
+#include "compat.h"
+#include <fsl_qbman_vportal.h>
+#include "qbman_portal.h"
+#include "qbman_ring.h"
+
+/* Frames a drain wants to see before re-reading the producer's head, the
+ * largest EQCR
+ */
+#define QBMAN_EQ_STAGE_BATCH 32
+
+/* Enqueue staging ring, filled by a thread and drained by the portal owner */
+struct qbman_eq_stage {
+	struct qbman_spsc r;
+	struct qbman_eq_desc *desc;
+	struct qbman_fd *fd;
+};
+
+static int qbman_eq_stage_init(struct qbman_eq_stage *st, uint32_t size)
+{
+	qbman_spsc_init(&st->r, size);
+	st->desc = malloc(size * sizeof(*st->desc));
+	st->fd = malloc(size * sizeof(*st->fd));
+	if (!st->desc || !st->fd)
+		return -ENOMEM;
+	return 0;
+}
+
+static void qbman_eq_stage_free(struct qbman_eq_stage *st)
+{
+	free(st->desc);
+	free(st->fd);
+}
+
+static int qbman_eq_stage_put(struct qbman_eq_stage *st,
+			      const struct qbman_eq_desc *d,
+			      const struct qbman_fd *fd, int num)
+{
+	uint32_t mask = st->r.size - 1;
+	uint32_t room = qbman_spsc_room(&st->r, num);
+	uint32_t i, idx;
+
+	if ((uint32_t)num > room)
+		num = room;
+	for (i = 0; i < (uint32_t)num; i++) {
+		idx = (st->r.head + i) & mask;
+		st->desc[idx] = d[i];
+		st->fd[idx] = fd[i];
+	}
+	if (num)
+		qbman_spsc_produce(&st->r, num);
+	return num;
+}
+
+/* Staged frames to the EQCR, in at most two contiguous runs of the ring.
+ * Returns how many went, stopping early if the EQCR is full.
+ */
+static int qbman_eq_stage_drain(struct qbman_eq_stage *st, struct qbman_swp *s)
+{
+	uint32_t mask = st->r.size - 1;
+	uint32_t avail = qbman_spsc_avail(&st->r, QBMAN_EQ_STAGE_BATCH);
+	uint32_t done = 0, idx, n;
+	int ret;
+
+	while (done < avail) {
+		idx = (st->r.tail + done) & mask;
+		n = avail - done;
+		if (n > st->r.size - idx)
+			n = st->r.size - idx;
+		ret = qbman_swp_enqueue_multiple_desc(s, &st->desc[idx],
+						      &st->fd[idx], n);
+		if (ret <= 0)
+			break;
+		done += ret;
+		if ((uint32_t)ret < n)
+			break;
+	}
+	if (done)
+		qbman_spsc_consume(&st->r, done);
+	return done;
+}
+
+/*******************/
+/* Virtual portals */
+/*******************/
+
+struct qbman_vportal {
+	struct qbman_eq_stage eq; /* thread -> owner */
+	struct qbman_spsc dq; /* owner -> thread */
+	struct qbman_result *inbox;
+	int id;
+};
+
+struct qbman_vportal_mux {
+	struct qbman_swp *swp;
+	struct qbman_vportal **vp;
+	uint32_t size;
+	uint32_t num;
+	uint32_t ring_size;
+	qbman_vportal_route_cb route;
+	void *ctx;
+	/* DQRR entry waiting for room in its inbox, or for the RCR if dropped */
+	const struct qbman_result *pending;
+	struct qbman_vportal *pending_vp;
+	struct qbman_vportal_mux_stats stats;
+};
+
+struct qbman_vportal_mux *qbman_vportal_mux_create(struct qbman_swp *s,
+						   uint32_t max_vportals,
+						   uint32_t ring_size,
+						   qbman_vportal_route_cb route,
+						   void *ctx)
+{
+	struct qbman_vportal_mux *mx;
+
+	if (!max_vportals || !route || !ring_size ||
+	    (ring_size & (ring_size - 1)))
+		return NULL;
+
+	mx = malloc(sizeof(*mx));
+	if (!mx)
+		return NULL;
+
+	memset(mx, 0, sizeof(*mx));
+	mx->vp = calloc(max_vportals, sizeof(*mx->vp));
+	if (!mx->vp) {
+		free(mx);
+		return NULL;
+	}
+	mx->swp = s;
+	mx->size = max_vportals;
+	mx->ring_size = ring_size;
+	mx->route = route;
+	mx->ctx = ctx;
+	return mx;
+}
+
+static void qbman_vportal_free(struct qbman_vportal *vp)
+{
+	if (!vp)
+		return;
+	qbman_eq_stage_free(&vp->eq);
+	free(vp->inbox);
+	free(vp);
+}
+
+void qbman_vportal_mux_destroy(struct qbman_vportal_mux *mx)
+{
+	uint32_t i;
+
+	if (!mx)
+		return;
+	for (i = 0; i < mx->num; i++)
+		qbman_vportal_free(mx->vp[i]);
+	free(mx->vp);
+	free(mx);
+}
+
+struct qbman_vportal *qbman_vportal_open(struct qbman_vportal_mux *mx)
+{
+	struct qbman_vportal *vp;
+	uint32_t n = mx->ring_size;
+
+	if (mx->num == mx->size)
+		return NULL;
+
+	if (posix_memalign((void **)&vp, 64, sizeof(*vp)))
+		return NULL;
+	memset(vp, 0, sizeof(*vp));
+	vp->inbox = malloc(n * sizeof(*vp->inbox));
+	if (qbman_eq_stage_init(&vp->eq, n) || !vp->inbox) {
+		pr_err("qbman_vportal: no memory for %u entry rings\n", n);
+		qbman_vportal_free(vp);
+		return NULL;
+	}
+	qbman_spsc_init(&vp->dq, n);
+	vp->id = mx->num;
+	mx->vp[mx->num++] = vp;
+	return vp;
+}
+
+int qbman_vportal_id(const struct qbman_vportal *vp)
+{
+	return vp->id;
+}
+
+int qbman_vportal_enqueue(struct qbman_vportal *vp,
+			  const struct qbman_eq_desc *d,
+			  const struct qbman_fd *fd, int num)
+{
+	return qbman_eq_stage_put(&vp->eq, d, fd, num);
+}
+
+int qbman_vportal_dequeue(struct qbman_vportal *vp, struct qbman_result *dq,
+			  int num)
+{
+	uint32_t mask = vp->dq.size - 1;
+	uint32_t avail = qbman_spsc_avail(&vp->dq, num);
+	uint32_t i;
+
+	if ((uint32_t)num > avail)
+		num = avail;
+	for (i = 0; i < (uint32_t)num; i++)
+		dq[i] = vp->inbox[(vp->dq.tail + i) & mask];
+	if (num)
+		qbman_spsc_consume(&vp->dq, num);
+	return num;
+}
+
+/* Return the buffer of a frame no virtual portal takes. Returns -EBUSY if the
+ * RCR can't take it yet.
+ */
+static int qbman_vportal_drop(struct qbman_vportal_mux *mx,
+			      const struct qbman_result *dq)
+{
+	int ret;
+
+	if (!qbman_result_is_DQ(dq) ||
+	    !(qbman_result_DQ_flags(dq) & QBMAN_DQ_STAT_VALIDFRAME))
+		return 0;
+
+	ret = qbman_fd_release_simple(mx->swp, qbman_result_DQ_fd(dq));
+	if (ret == -EBUSY)
+		return ret;
+	if (ret)
+		mx->stats.unreleased++;
+	else
+		mx->stats.dropped++;
+	return 0;
+}
+
+/* Copy a DQRR entry to its inbox, or drop it if @vp is NULL, and consume it.
+ * Returns 0 if the inbox (or the RCR) is full and the entry has to stay in
+ * DQRR.
+ */
+static int qbman_vportal_deliver(struct qbman_vportal_mux *mx,
+				 struct qbman_vportal *vp,
+				 const struct qbman_result *dq)
+{
+	if (vp) {
+		if (!qbman_spsc_room(&vp->dq, 1))
+			return 0;
+		vp->inbox[vp->dq.head & (vp->dq.size - 1)] = *dq;
+		qbman_spsc_produce(&vp->dq, 1);
+	} else if (qbman_vportal_drop(mx, dq)) {
+		return 0;
+	}
+	qbman_swp_dqrr_consume(mx->swp, dq);
+	return 1;
+}
+
+int qbman_vportal_mux_service(struct qbman_vportal_mux *mx, int budget)
+{
+	const struct qbman_result *dq;
+	struct qbman_vportal *vp;
+	uint32_t i;
+	int id, work = 0;
+
+	for (i = 0; i < mx->num; i++)
+		work += qbman_eq_stage_drain(&mx->vp[i]->eq, mx->swp);
+
+	if (mx->pending) {
+		if (!qbman_vportal_deliver(mx, mx->pending_vp, mx->pending))
+			return work;
+		mx->pending = NULL;
+		work++;
+		budget--;
+	}
+
+	while (budget-- > 0) {
+		dq = qbman_swp_dqrr_next(mx->swp);
+		if (!dq)
+			break;
+		id = mx->route(mx->ctx, dq);
+		vp = NULL;
+		if ((uint32_t)id < mx->num)
+			vp = mx->vp[id];
+		else if (id >= 0)
+			mx->stats.misrouted++;
+		if (!qbman_vportal_deliver(mx, vp, dq)) {
+			mx->pending = dq;
+			mx->pending_vp = vp;
+			break;
+		}
+		work++;
+	}
+	return work;
+}
+
+void qbman_vportal_mux_stats_get(const struct qbman_vportal_mux *mx,
+				 struct qbman_vportal_mux_stats *st)
+{
+	*st = mx->stats;
+}
+
+/****************/
+/* Portal proxy */
+/****************/
+
+/* Management requests run per client and service pass, so a burst of them
+ * doesn't hold up the data path
+ */
+#define QBMAN_PROXY_CALL_BATCH 4
+
+struct qbman_proxy_client {
+	struct qbman_eq_stage eq;
+	struct qbman_spsc rel;
+	uint64_t *rel_buf;
+	uint16_t *rel_bpid;
+	struct qbman_spsc call;
+	struct qbman_proxy_req **call_req;
+};
+
+struct qbman_proxy {
+	struct qbman_swp *swp;
+	struct qbman_proxy_client **c;
+	uint32_t size;
+	uint32_t num;
+	uint32_t ring_size;
+};
+
+struct qbman_proxy *qbman_proxy_create(struct qbman_swp *s,
+				       uint32_t max_clients,
+				       uint32_t ring_size)
+{
+	struct qbman_proxy *px;
+
+	if (!max_clients || !ring_size || (ring_size & (ring_size - 1)))
+		return NULL;
+
+	px = malloc(sizeof(*px));
+	if (!px)
+		return NULL;
+
+	memset(px, 0, sizeof(*px));
+	px->c = calloc(max_clients, sizeof(*px->c));
+	if (!px->c) {
+		free(px);
+		return NULL;
+	}
+	px->swp = s;
+	px->size = max_clients;
+	px->ring_size = ring_size;
+	return px;
+}
+
+static void qbman_proxy_client_free(struct qbman_proxy_client *c)
+{
+	if (!c)
+		return;
+	qbman_eq_stage_free(&c->eq);
+	free(c->rel_buf);
+	free(c->rel_bpid);
+	free(c->call_req);
+	free(c);
+}
+
+void qbman_proxy_destroy(struct qbman_proxy *px)
+{
+	uint32_t i;
+
+	if (!px)
+		return;
+	for (i = 0; i < px->num; i++)
+		qbman_proxy_client_free(px->c[i]);
+	free(px->c);
+	free(px);
+}
+
+struct qbman_proxy_client *qbman_proxy_client_open(struct qbman_proxy *px)
+{
+	struct qbman_proxy_client *c;
+	uint32_t n = px->ring_size;
+
+	if (px->num == px->size)
+		return NULL;
+
+	if (posix_memalign((void **)&c, 64, sizeof(*c)))
+		return NULL;
+	memset(c, 0, sizeof(*c));
+	c->rel_buf = malloc(n * sizeof(*c->rel_buf));
+	c->rel_bpid = malloc(n * sizeof(*c->rel_bpid));
+	c->call_req = malloc(n * sizeof(*c->call_req));
+	if (qbman_eq_stage_init(&c->eq, n) ||
+	    !c->rel_buf || !c->rel_bpid || !c->call_req) {
+		pr_err("qbman_proxy: no memory for %u entry rings\n", n);
+		qbman_proxy_client_free(c);
+		return NULL;
+	}
+	qbman_spsc_init(&c->rel, n);
+	qbman_spsc_init(&c->call, n);
+	px->c[px->num++] = c;
+	return c;
+}
+
+int qbman_proxy_enqueue(struct qbman_proxy_client *c,
+			const struct qbman_eq_desc *d,
+			const struct qbman_fd *fd, int num)
+{
+	return qbman_eq_stage_put(&c->eq, d, fd, num);
+}
+
+int qbman_proxy_release(struct qbman_proxy_client *c, uint16_t bpid,
+			const uint64_t *buffers, int num)
+{
+	uint32_t mask = c->rel.size - 1;
+	uint32_t room = qbman_spsc_room(&c->rel, num);
+	uint32_t i, idx;
+
+	if ((uint32_t)num > room)
+		num = room;
+	for (i = 0; i < (uint32_t)num; i++) {
+		idx = (c->rel.head + i) & mask;
+		c->rel_buf[idx] = buffers[i];
+		c->rel_bpid[idx] = bpid;
+	}
+	if (num)
+		qbman_spsc_produce(&c->rel, num);
+	return num;
+}
+
+int qbman_proxy_call(struct qbman_proxy_client *c, struct qbman_proxy_req *req)
+{
+	if (!qbman_spsc_room(&c->call, 1))
+		return -EBUSY;
+
+	req->done = 0;
+	c->call_req[c->call.head & (c->call.size - 1)] = req;
+	qbman_spsc_produce(&c->call, 1);
+	return 0;
+}
+
+int qbman_proxy_req_done(const struct qbman_proxy_req *req)
+{
+	if (!req->done)
+		return 0;
+	/* Pairs with the smp_wmb() between 'ret' and 'done' in the owner */
+	smp_rmb();
+	return 1;
+}
+
+/* Staged releases, grouped into commands of up to 7 buffers of the same pool.
+ * Returns how many buffers went, stopping early if the RCR is busy.
+ */
+static int qbman_proxy_drain_rel(struct qbman_proxy_client *c,
+				 struct qbman_swp *s)
+{
+	uint64_t bufs[7];
+	uint32_t mask = c->rel.size - 1;
+	uint32_t avail = qbman_spsc_avail(&c->rel, 7);
+	uint32_t done = 0, n;
+	uint16_t bpid;
+
+	while (done < avail) {
+		bpid = c->rel_bpid[(c->rel.tail + done) & mask];
+		for (n = 0; n < 7 && done + n < avail; n++) {
+			if (c->rel_bpid[(c->rel.tail + done + n) & mask] != bpid)
+				break;
+			bufs[n] = c->rel_buf[(c->rel.tail + done + n) & mask];
+		}
+		if (qbman_swp_release_bpid(s, bpid, bufs, n))
+			break;
+		done += n;
+	}
+	if (done)
+		qbman_spsc_consume(&c->rel, done);
+	return done;
+}
+
+static int qbman_proxy_drain_call(struct qbman_proxy_client *c,
+				  struct qbman_swp *s)
+{
+	struct qbman_proxy_req *req;
+	uint32_t avail = qbman_spsc_avail(&c->call, 1);
+	uint32_t i;
+
+	if (avail > QBMAN_PROXY_CALL_BATCH)
+		avail = QBMAN_PROXY_CALL_BATCH;
+
+	for (i = 0; i < avail; i++) {
+		req = c->call_req[(c->call.tail + i) & (c->call.size - 1)];
+		req->ret = req->fn(s, req->arg);
+		smp_wmb();
+		req->done = 1;
+	}
+	if (avail)
+		qbman_spsc_consume(&c->call, avail);
+	return avail;
+}
+
+int qbman_proxy_service(struct qbman_proxy *px)
+{
+	struct qbman_proxy_client *c;
+	uint32_t i;
+	int work = 0;
+
+	for (i = 0; i < px->num; i++) {
+		c = px->c[i];
+		work += qbman_eq_stage_drain(&c->eq, px->swp);
+		work += qbman_proxy_drain_rel(c, px->swp);
+		work += qbman_proxy_drain_call(c, px->swp);
+	}
+	return work;
+}
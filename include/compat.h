@@ -90,6 +90,15 @@ static inline uint64_t read_free_running_frequency_counter(void)
 	return ret;
 }
 
+/* Ticks per second of read_free_running_frequency_counter() */
+static inline uint64_t read_free_running_frequency(void)
+{
+	uint64_t ret;
+
+	asm volatile ("mrs %0, cntfrq_el0" : "=r" (ret));
+	return ret;
+}
+
 #ifdef RTE_LIBRTE_DPAA2_DEBUG_BUS
 
 /* Trace the 3 different classes of read/write access to QBMan.
@@ -126,6 +135,8 @@ do { \
 
 /* sequential memory pages, memory barier / fence */
 #define smp_mb() dmb(ish)
+#define smp_rmb() dmb(ishld)
+#define smp_wmb() dmb(ishst)
 #define dma_wmb() dmb(ish)
 
 /* Atomic stuff */
@@ -0,0 +1,95 @@
+/* Copyright 2026 NXP
+ *
+ * SPDX-License-Identifier:        BSD-3-Clause
+ */
+
+#ifndef _FSL_QBMAN_DEMUX_H
+#define _FSL_QBMAN_DEMUX_H
+
+#include <fsl_qbman_portal.h>
+
+/* Flow-context demultiplexer.
+ *
+ * Each registered flow gets a 64-bit value to program as the FQ context of the
+ * FQs feeding it. That value is the address of the flow's 64-byte aligned
+ * slot in the demux table with a 6-bit generation tag in the low bits, so a
+ * dequeued frame is resolved to its handler by a range and tag check on
+ * qbman_result_DQ_fqd_ctx(), without any hashing. Registration is a control
+ * path operation and is not safe against concurrent qbman_demux_burst() calls
+ * on the same demux.
+ */
+struct qbman_demux;
+
+/* Frames resolved per qbman_demux_burst() call, larger bursts are split */
+#define QBMAN_DEMUX_BURST_MAX 32
+
+/**
+ * typedef qbman_demux_handler - Handler for a vector of results
+ * @ctx: the context object given at registration.
+ * @s: the software portal the results were dequeued from.
+ * @dq: the results, in dequeue order.
+ * @num: the number of results in @dq.
+ *
+ * The handler owns the results, in particular it consumes DQRR entries.
+ */
+typedef void (*qbman_demux_handler)(void *ctx, struct qbman_swp *s,
+				    const struct qbman_result **dq, int num);
+
+/**
+ * qbman_demux_create() - Create a demux.
+ * @max_flows: the number of flows that can be registered at the same time.
+ *
+ * Return the demux, or NULL on failure.
+ */
+struct qbman_demux *qbman_demux_create(uint32_t max_flows);
+
+/**
+ * qbman_demux_destroy() - Free a demux.
+ * @dm: the demux, any FQ context derived from it becomes invalid.
+ */
+void qbman_demux_destroy(struct qbman_demux *dm);
+
+/**
+ * qbman_demux_register() - Register a flow.
+ * @dm: the demux.
+ * @handler: called with the frames of the flow.
+ * @ctx: passed back to @handler.
+ * @fqd_ctx: returns the value to program as FQ context of the flow's FQs.
+ *
+ * Return 0 for success, -EINVAL for a NULL handler, or -ENOSPC if all flows
+ * are in use.
+ */
+int qbman_demux_register(struct qbman_demux *dm, qbman_demux_handler handler,
+			 void *ctx, uint64_t *fqd_ctx);
+
+/**
+ * qbman_demux_unregister() - Unregister a flow.
+ * @dm: the demux.
+ * @fqd_ctx: the value returned by qbman_demux_register().
+ *
+ * Frames still carrying @fqd_ctx are handed to the miss handler from then on.
+ *
+ * Return 0 for success, or -EINVAL if @fqd_ctx is not a registered flow.
+ */
+int qbman_demux_unregister(struct qbman_demux *dm, uint64_t fqd_ctx);
+
+/**
+ * qbman_demux_burst() - Deliver a burst of results to the flow handlers.
+ * @dm: the demux.
+ * @s: the software portal the results were dequeued from.
+ * @dq: the results, e.g. from qbman_swp_dqrr_next_burst().
+ * @num: the number of results.
+ * @miss: handler for results that are not frame dequeues or whose FQ context
+ * does not resolve to a registered flow, NULL to ignore them.
+ * @miss_ctx: passed back to @miss.
+ *
+ * Results of the same flow are grouped, keeping their relative order, and
+ * given to the flow's handler in a single call.
+ *
+ * Return the number of results delivered to flow handlers.
+ */
+int qbman_demux_burst(const struct qbman_demux *dm, struct qbman_swp *s,
+		      const struct qbman_result **dq, int num,
+		      qbman_demux_handler miss, void *miss_ctx);
+
+#endif /* !_FSL_QBMAN_DEMUX_H */
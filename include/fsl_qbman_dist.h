@@ -0,0 +1,122 @@
+/* Copyright 2026 NXP
+ *
+ * SPDX-License-Identifier:        BSD-3-Clause
+ */
+
+#ifndef _FSL_QBMAN_DIST_H
+#define _FSL_QBMAN_DIST_H
+
+#include <fsl_qbman_portal.h>
+
+/* Flow distribution.
+ *
+ * A distribution table spreads flows over FQs, or over the bins of a queuing
+ * destination, RSS style. Each frame's flow key (e.g. its 5-tuple, gathered
+ * by the caller) is hashed with CRC32C, using the ARMv8 CRC32 instructions
+ * when the CPU has them and an equivalent table-driven version otherwise, and
+ * the hash indexes a power of 2 indirection table of FQIDs or QD bins.
+ * Entries can be rewritten with qbman_dist_set_entry() while producers use the
+ * table, to rebalance flows live; each frame sees either the old or the new
+ * target.
+ */
+struct qbman_dist;
+
+/**
+ * qbman_dist_hash() - Hash a flow key.
+ * @key: the key.
+ * @len: the key length in bytes.
+ * @seed: the initial CRC value.
+ *
+ * Return the CRC32C of @key.
+ */
+uint32_t qbman_dist_hash(const void *key, uint32_t len, uint32_t seed);
+
+/**
+ * qbman_dist_hash_burst() - Hash the flow keys of a burst of frames.
+ * @keys: the keys, all of the same length.
+ * @len: the key length in bytes.
+ * @seed: the initial CRC value.
+ * @hash: returns the hash of each key, as qbman_dist_hash().
+ * @num: the number of keys.
+ */
+void qbman_dist_hash_burst(const void * const *keys, uint32_t len,
+			   uint32_t seed, uint32_t *hash, int num);
+
+/**
+ * qbman_dist_create() - Create a distribution table.
+ * @table_size: the number of entries, a power of 2.
+ * @seed: the hash seed.
+ *
+ * The table starts out targeting FQs, with all entries 0.
+ *
+ * Return the table, or NULL on failure.
+ */
+struct qbman_dist *qbman_dist_create(uint32_t table_size, uint32_t seed);
+
+/**
+ * qbman_dist_destroy() - Free a distribution table.
+ * @dist: the table.
+ */
+void qbman_dist_destroy(struct qbman_dist *dist);
+
+/**
+ * qbman_dist_set_qd() - Target the bins of a queuing destination.
+ * @dist: the table.
+ * @qdid: the queuing destination.
+ * @qd_prio: the queuing destination priority.
+ *
+ * From then on the entries are QD bins rather than FQIDs. Not to be called
+ * while the table is in use.
+ */
+void qbman_dist_set_qd(struct qbman_dist *dist, uint32_t qdid,
+		       uint8_t qd_prio);
+
+/**
+ * qbman_dist_set_entry() - Set an entry of the indirection table.
+ * @dist: the table.
+ * @idx: the entry index.
+ * @target: the FQID or QD bin.
+ *
+ * Can be called while producers use the table.
+ *
+ * Return 0 for success, or -EINVAL if @idx is out of range.
+ */
+int qbman_dist_set_entry(struct qbman_dist *dist, uint32_t idx,
+			 uint32_t target);
+
+/**
+ * qbman_dist_fill() - Spread targets evenly over the indirection table.
+ * @dist: the table.
+ * @targets: the FQIDs or QD bins.
+ * @num: the number of targets.
+ *
+ * Return 0 for success, or -EINVAL if @num is 0.
+ */
+int qbman_dist_fill(struct qbman_dist *dist, const uint32_t *targets,
+		    uint32_t num);
+
+/**
+ * qbman_dist_lookup() - Get the target of a flow hash.
+ * @dist: the table.
+ * @hash: the flow hash.
+ *
+ * Return the FQID or QD bin.
+ */
+uint32_t qbman_dist_lookup(const struct qbman_dist *dist, uint32_t hash);
+
+/**
+ * qbman_dist_desc_burst() - Target a burst of frames by flow.
+ * @dist: the table.
+ * @tmpl: the enqueue descriptor template.
+ * @keys: the flow key of each frame.
+ * @key_len: the length of each key in bytes.
+ * @d: returns one descriptor per frame, for
+ * qbman_swp_enqueue_multiple_desc().
+ * @num: the number of frames.
+ */
+void qbman_dist_desc_burst(const struct qbman_dist *dist,
+			   const struct qbman_eq_desc *tmpl,
+			   const void * const *keys, uint32_t key_len,
+			   struct qbman_eq_desc *d, int num);
+
+#endif /* !_FSL_QBMAN_DIST_H */
@@ -0,0 +1,115 @@
+/* Copyright 2026 NXP
+ *
+ * SPDX-License-Identifier:        BSD-3-Clause
+ */
+
+#ifndef _FSL_QBMAN_ERN_H
+#define _FSL_QBMAN_ERN_H
+
+#include <fsl_qbman_portal.h>
+
+/* Enqueue rejection handling.
+ *
+ * An ERN handler owns a ring of enqueue response slots in DMA-able memory.
+ * Each enqueue that should be tracked gets the next slot with
+ * qbman_ern_desc_set(), and qbman_ern_poll() later harvests the responses in
+ * order from the portal's own loop. Rejected frames are passed to an optional
+ * callback; unless the callback keeps the frame, the buffer of a single-buffer
+ * FD is returned to its BPID, with releases to the same pool merged into
+ * commands of up to 7 buffers. Releases the RCR can't take yet are kept and
+ * retried on the next poll, so a busy RCR never leaks buffers.
+ *
+ * Slots are recycled in order, so qbman_ern_desc_set() has every tracked
+ * enqueue write a response, on success too, whatever qbman_eq_desc_set_no_orp()
+ * or qbman_eq_desc_set_orp() asked for. Since each frame needs its own slot,
+ * use qbman_swp_enqueue() or qbman_swp_enqueue_multiple_desc() for tracked
+ * enqueues, not qbman_swp_enqueue_multiple().
+ */
+struct qbman_ern;
+
+/**
+ * typedef qbman_ern_cb - Handle a rejected enqueue
+ * @ctx: the context given to qbman_ern_create().
+ * @rc: the response code, see qbman_result_eqresp_rc().
+ * @rsp: the enqueue response, qbman_result_eqresp_fd() gives the frame.
+ *
+ * Return 0 to have the buffer released by the handler, non-zero if the
+ * callback took care of the frame.
+ */
+typedef int (*qbman_ern_cb)(void *ctx, uint8_t rc,
+			    const struct qbman_result *rsp);
+
+/**
+ * struct qbman_ern_stats - Enqueue response counters
+ * @enqueued: responses for frames that were enqueued.
+ * @rejected: responses for rejected frames.
+ * @released: buffers of rejected frames released back to their pool.
+ * @unreleased: rejected frames left to the callback that it did not take and
+ * whose buffer could not be released, e.g. scatter/gather frames.
+ */
+struct qbman_ern_stats {
+	uint64_t enqueued;
+	uint64_t rejected;
+	uint64_t released;
+	uint64_t unreleased;
+};
+
+/**
+ * qbman_ern_create() - Create an ERN handler.
+ * @ring: the response slots, 64-byte aligned DMA-able memory.
+ * @ring_iova: the address of @ring as seen by QBMan.
+ * @size: the number of slots, a power of 2.
+ * @cb: called for each rejected frame, may be NULL.
+ * @ctx: passed back to @cb.
+ *
+ * Return the handler, or NULL on failure.
+ */
+struct qbman_ern *qbman_ern_create(struct qbman_result *ring,
+				   uint64_t ring_iova, uint32_t size,
+				   qbman_ern_cb cb, void *ctx);
+
+/**
+ * qbman_ern_destroy() - Free an ERN handler.
+ * @e: the handler, buffers still waiting to be released are dropped.
+ */
+void qbman_ern_destroy(struct qbman_ern *e);
+
+/**
+ * qbman_ern_desc_set() - Direct the response of an enqueue to the next slot.
+ * @e: the handler.
+ * @d: the enqueue descriptor, its response address and token are set and it
+ * is switched to respond on success too. Call after qbman_eq_desc_set_no_orp()
+ * or qbman_eq_desc_set_orp().
+ *
+ * Every descriptor set up this way must be enqueued, in the order the slots
+ * were taken.
+ *
+ * Return 0 for success, or -EBUSY if all slots are waiting for a response.
+ */
+int qbman_ern_desc_set(struct qbman_ern *e, struct qbman_eq_desc *d);
+
+/**
+ * qbman_ern_poll() - Harvest enqueue responses.
+ * @e: the handler.
+ * @s: the software portal used to release buffers.
+ * @budget: the most responses to handle.
+ *
+ * Return the number of responses handled.
+ */
+int qbman_ern_poll(struct qbman_ern *e, struct qbman_swp *s, int budget);
+
+/**
+ * qbman_ern_pending() - Get the number of slots waiting for a response.
+ * @e: the handler.
+ */
+uint32_t qbman_ern_pending(const struct qbman_ern *e);
+
+/**
+ * qbman_ern_stats_get() - Read the handler counters.
+ * @e: the handler.
+ * @st: returns the counters.
+ */
+void qbman_ern_stats_get(const struct qbman_ern *e,
+			 struct qbman_ern_stats *st);
+
+#endif /* !_FSL_QBMAN_ERN_H */
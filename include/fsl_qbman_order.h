@@ -0,0 +1,189 @@
+/* Copyright 2026 NXP
+ *
+ * SPDX-License-Identifier:        BSD-3-Clause
+ */
+
+#ifndef _FSL_QBMAN_ORDER_H
+#define _FSL_QBMAN_ORDER_H
+
+#include <fsl_qbman_portal.h>
+
+/* ----------------- */
+/* Order restoration */
+/* ----------------- */
+
+/* Frames dequeued from an FQ with an order restoration point carry the ORP id
+ * and their sequence number. To have QMan put them back in order, whichever
+ * core processed a frame enqueues it with that sequence info, or fills the
+ * hole left by a dropped frame. qbman_orp_seq_get() captures the info at
+ * dequeue time, it then travels with the frame (e.g. in its software
+ * annotation) to qbman_orp_desc_set() or qbman_orp_desc_burst() at enqueue
+ * time. Holes and NESN updates are staged in a per-portal ORP context and
+ * issued together with qbman_swp_enqueue_multiple_desc().
+ */
+
+/**
+ * struct qbman_orp_seq - Order restoration info of a dequeued frame
+ * @odpid: the order restoration point id.
+ * @seqnum: the sequence number of the frame.
+ * @valid: non-zero if the frame came from an FQ with an ORP.
+ */
+struct qbman_orp_seq {
+	uint16_t odpid;
+	uint16_t seqnum;
+	uint8_t valid;
+};
+
+struct qbman_orp_ctx;
+
+/**
+ * qbman_orp_seq_get() - Capture the order restoration info of a frame.
+ * @dq: the frame dequeue result.
+ * @seq: returns the info, @seq->valid is 0 if the FQ has no ORP.
+ */
+void qbman_orp_seq_get(const struct qbman_result *dq,
+		       struct qbman_orp_seq *seq);
+
+/**
+ * qbman_orp_desc_set() - Set the order restoration of an enqueue.
+ * @d: the enqueue descriptor, its existing ORP and response settings are
+ * replaced.
+ * @seq: the info captured at dequeue, enqueued without ORP if not valid.
+ * @respond_success: as for qbman_eq_desc_set_orp().
+ * @incomplete: non-zero if more fragments of the same frame follow.
+ */
+void qbman_orp_desc_set(struct qbman_eq_desc *d,
+			const struct qbman_orp_seq *seq,
+			int respond_success, int incomplete);
+
+/**
+ * qbman_orp_desc_burst() - Build enqueue descriptors for a burst of frames.
+ * @tmpl: the descriptor template, with target and other settings.
+ * @seq: the order restoration info of each frame.
+ * @d: returns one descriptor per frame, for
+ * qbman_swp_enqueue_multiple_desc().
+ * @num: the number of frames.
+ * @respond_success: as for qbman_eq_desc_set_orp().
+ */
+void qbman_orp_desc_burst(const struct qbman_eq_desc *tmpl,
+			  const struct qbman_orp_seq *seq,
+			  struct qbman_eq_desc *d, int num,
+			  int respond_success);
+
+/**
+ * qbman_orp_ctx_create() - Create an ORP context for a software portal.
+ * @s: the software portal the hole and NESN commands are issued on.
+ * @max_pending: the number of commands that can be staged.
+ *
+ * Return the context, or NULL on failure.
+ */
+struct qbman_orp_ctx *qbman_orp_ctx_create(struct qbman_swp *s,
+					   uint32_t max_pending);
+
+/**
+ * qbman_orp_ctx_destroy() - Free an ORP context.
+ * @oc: the context, staged commands are dropped.
+ */
+void qbman_orp_ctx_destroy(struct qbman_orp_ctx *oc);
+
+/**
+ * qbman_orp_drop() - Stage a hole for a dropped frame.
+ * @oc: the context.
+ * @seq: the info captured when the frame was dequeued.
+ *
+ * Flushes the context first if it is full.
+ *
+ * Return 0 for success, or -EBUSY if the context is full and the EQCR can't
+ * take any command.
+ */
+int qbman_orp_drop(struct qbman_orp_ctx *oc, const struct qbman_orp_seq *seq);
+
+/**
+ * qbman_orp_nesn() - Stage a next expected sequence number update.
+ * @oc: the context.
+ * @odpid: the order restoration point id.
+ * @seqnum: the new next expected sequence number.
+ *
+ * Return 0 for success, or -EBUSY as for qbman_orp_drop().
+ */
+int qbman_orp_nesn(struct qbman_orp_ctx *oc, uint16_t odpid, uint16_t seqnum);
+
+/**
+ * qbman_orp_flush() - Issue the staged hole and NESN commands.
+ * @oc: the context.
+ *
+ * Return the number of commands still staged.
+ */
+int qbman_orp_flush(struct qbman_orp_ctx *oc);
+
+/* ---------------------- */
+/* Held-active completion */
+/* ---------------------- */
+
+/* A DQRR entry of an atomic FQ (QBMAN_DQ_STAT_HELDACTIVE) keeps the FQ locked
+ * to the portal until the entry is consumed. A hold tracker records the DQRR
+ * entries of a burst as they are harvested; frames that get enqueued have
+ * their entry consumed by that enqueue through DCA, and whatever is left is
+ * consumed together at the end of the burst with qbman_hold_complete(), rather
+ * than one DCAP write per frame in the middle of processing.
+ */
+struct qbman_hold_tracker {
+	uint16_t pending; /* bit n: DQRR entry n still to be consumed */
+	uint16_t held; /* bit n: DQRR entry n is held active */
+};
+
+/**
+ * qbman_hold_tracker_init() - Initialise a hold tracker.
+ * @t: the tracker.
+ */
+void qbman_hold_tracker_init(struct qbman_hold_tracker *t);
+
+/**
+ * qbman_hold_track() - Record a DQRR entry of the current burst.
+ * @t: the tracker.
+ * @dq: the DQRR entry, not consumed.
+ *
+ * Return 1 if the entry is held active, 0 otherwise.
+ */
+int qbman_hold_track(struct qbman_hold_tracker *t,
+		     const struct qbman_result *dq);
+
+/**
+ * qbman_hold_desc_set_dca() - Have an enqueue consume a tracked DQRR entry.
+ * @t: the tracker.
+ * @d: the enqueue descriptor of the frame dequeued from @dq.
+ * @dq: the tracked DQRR entry.
+ * @park: park the FQ instead of rescheduling it, if it is held active.
+ *
+ * The enqueue must then be issued; if it is not, consume @dq with
+ * qbman_swp_dqrr_consume().
+ *
+ * Return 1 if DCA was set, 0 if @dq is not pending in @t.
+ */
+int qbman_hold_desc_set_dca(struct qbman_hold_tracker *t,
+			    struct qbman_eq_desc *d,
+			    const struct qbman_result *dq, int park);
+
+/**
+ * qbman_hold_eq_flags() - Have an enqueue consume a tracked DQRR entry.
+ * @t: the tracker.
+ * @dq: the tracked DQRR entry.
+ *
+ * As qbman_hold_desc_set_dca(), for the per-frame flags of
+ * qbman_swp_enqueue_multiple().
+ *
+ * Return the enqueue flags, 0 if @dq is not pending in @t.
+ */
+uint32_t qbman_hold_eq_flags(struct qbman_hold_tracker *t,
+			     const struct qbman_result *dq);
+
+/**
+ * qbman_hold_complete() - Consume the DQRR entries left at the end of a burst.
+ * @t: the tracker, empty on return.
+ * @s: the software portal the entries were dequeued from.
+ *
+ * Return the number of entries consumed.
+ */
+int qbman_hold_complete(struct qbman_hold_tracker *t, struct qbman_swp *s);
+
+#endif /* !_FSL_QBMAN_ORDER_H */
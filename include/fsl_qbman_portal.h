@@ -65,6 +65,11 @@ struct qbman_swp *qbman_swp_init(const struct qbman_swp_desc *d);
  * the given QBMan portal descriptor.
  * @p: the qbman_swp object to be destroyed.
  *
+ * Frames in the software enqueue backlog are handed to the EQCR and any
+ * deferred doorbell is rung first. Frames the EQCR still can't take are
+ * dropped and reported; to handle them instead, drain the backlog with
+ * qbman_swp_enqueue_backlog_flush() until it is empty and disable it with
+ * qbman_swp_enqueue_backlog_set(s, 0) before finishing the portal.
  */
 void qbman_swp_finish(struct qbman_swp *p);
 
@@ -238,6 +243,22 @@ struct qbman_result {
 			__le32 rid_tok;
 			__le64 ctx;
 		} scn;
+		struct eq_resp {
+			uint8_t verb;
+			uint8_t dca;
+			__le16 seqnum;
+			__le16 oprid;
+			uint8_t reserved;
+			uint8_t rc;
+			__le32 tgtid;
+			__le32 tag;
+			uint16_t qdbin;
+			uint8_t qpri;
+			uint8_t reserved1[4];
+			uint8_t rspid;
+			__le64 rsp_addr;
+			uint8_t fd[32];
+		} eq_resp;
 	};
 };
 
@@ -288,6 +309,61 @@ void qbman_swp_push_get(struct qbman_swp *s, uint8_t channel_idx, int *enabled);
  */
 void qbman_swp_push_set(struct qbman_swp *s, uint8_t channel_idx, int enable);
 
+/**
+ * qbman_swp_push_get_mask() - Get the push dequeue channel mask.
+ * @s: the software portal object.
+ *
+ * Return the mask, bit n set if push dequeue is enabled for channel index n.
+ */
+uint16_t qbman_swp_push_get_mask(struct qbman_swp *s);
+
+/**
+ * qbman_swp_push_set_mask() - Enable push dequeue for a set of channels.
+ * @s: the software portal object.
+ * @channel_mask: bit n enables push dequeue for channel index n, the channels
+ * not in the mask are disabled.
+ *
+ * Same as a qbman_swp_push_set() per channel index, but with a single write
+ * of the SDQCR.
+ */
+void qbman_swp_push_set_mask(struct qbman_swp *s, uint16_t channel_mask);
+
+/**
+ * enum qbman_sdqcr_dct - Dequeue command type of push dequeues
+ * @qbman_sdqcr_dct_null: null.
+ * @qbman_sdqcr_dct_prio_ics: priority precedence, respect intra-class
+ * scheduling. The default.
+ * @qbman_sdqcr_dct_active_ics: active FQ precedence, respect ICS.
+ * @qbman_sdqcr_dct_active: active FQ precedence, no ICS.
+ */
+enum qbman_sdqcr_dct {
+	qbman_sdqcr_dct_null = 0,
+	qbman_sdqcr_dct_prio_ics,
+	qbman_sdqcr_dct_active_ics,
+	qbman_sdqcr_dct_active
+};
+
+/**
+ * enum qbman_sdqcr_fc - Frame count of push dequeues
+ * @qbman_sdqcr_fc_one: one frame per dequeue.
+ * @qbman_sdqcr_fc_up_to_3: up to 3 frames per dequeue. The default.
+ */
+enum qbman_sdqcr_fc {
+	qbman_sdqcr_fc_one = 0,
+	qbman_sdqcr_fc_up_to_3 = 1
+};
+
+/**
+ * qbman_swp_push_set_mode() - Set how push dequeues are done on the portal.
+ * @s: the software portal object.
+ * @dct: the dequeue command type.
+ * @fc: the frame count.
+ *
+ * Return 0 for success, or -EINVAL for an invalid mode.
+ */
+int qbman_swp_push_set_mode(struct qbman_swp *s, enum qbman_sdqcr_dct dct,
+			    enum qbman_sdqcr_fc fc);
+
 /* ------------------- */
 /* Pull-mode dequeuing */
 /* ------------------- */
@@ -429,6 +505,115 @@ const struct qbman_result *qbman_swp_dqrr_next(struct qbman_swp *p);
  */
 void qbman_swp_prefetch_dqrr_next(struct qbman_swp *s);
 
+/**
+ * qbman_swp_dqrr_ready() - Check for a new DQRR entry without taking it.
+ * @s: the software portal object.
+ *
+ * Only looks at the valid-bit of the next entry, qbman_swp_dqrr_next() still
+ * has to be called to get it. May report an entry that is not there on QMan
+ * versions which need the DQRR reset workaround.
+ *
+ * Return non-zero if qbman_swp_dqrr_next() would likely return an entry.
+ */
+int qbman_swp_dqrr_ready(struct qbman_swp *s);
+
+/**
+ * enum qbman_dqrr_prefetch_e - What qbman_swp_dqrr_next() does with the next
+ * DQRR entry when it returns one.
+ * @qbman_dqrr_prefetch_none: nothing, the caller may use
+ * qbman_swp_prefetch_dqrr_next().
+ * @qbman_dqrr_prefetch_next: prefetch the next entry.
+ * @qbman_dqrr_prefetch_inval_next: invalidate and prefetch the next entry, for
+ * non-coherent portal mappings.
+ */
+enum qbman_dqrr_prefetch_e {
+	qbman_dqrr_prefetch_none = 0,
+	qbman_dqrr_prefetch_next,
+	qbman_dqrr_prefetch_inval_next,
+};
+
+/**
+ * qbman_swp_dqrr_prefetch_set() - Set the next-entry prefetch mode of the
+ * portal, qbman_dqrr_prefetch_none by default.
+ * @s: the software portal object.
+ * @mode: the prefetch mode.
+ *
+ * Return 0 for success, or -EINVAL for an unknown mode.
+ */
+int qbman_swp_dqrr_prefetch_set(struct qbman_swp *s,
+				enum qbman_dqrr_prefetch_e mode);
+
+/**
+ * qbman_swp_dqrr_next_burst() - Harvest up to @num valid DQRR entries.
+ * @s: the software portal object.
+ * @dq: array receiving the DQRR entries.
+ * @num: the size of @dq.
+ *
+ * Same as calling qbman_swp_dqrr_next() until it returns NULL or @num entries
+ * are collected, but the portal housekeeping is done once per burst. If frame
+ * prefetch is enabled with qbman_swp_fd_prefetch_set(), it is issued for the
+ * first 'distance' frames as they are harvested; the caller keeps the window
+ * rolling by calling qbman_swp_prefetch_fd_window() for each frame it
+ * processes.
+ *
+ * Return the number of entries stored in @dq.
+ */
+int qbman_swp_dqrr_next_burst(struct qbman_swp *s,
+			      const struct qbman_result **dq, int num);
+
+/* Prefetch the frame buffer at FD address + offset */
+#define QBMAN_PREFETCH_FD_DATA	0x1
+/* Prefetch the flow context that 'fqd_ctx' points to */
+#define QBMAN_PREFETCH_FQD_CTX	0x2
+
+/**
+ * typedef qbman_iova_to_va_cb - Translate a frame address to a virtual address
+ * @iova: the FD address plus offset.
+ */
+typedef void *(*qbman_iova_to_va_cb)(uint64_t iova);
+
+/**
+ * qbman_swp_fd_prefetch_set() - Configure frame prefetch on DQRR harvest.
+ * @s: the software portal object.
+ * @flags: QBMAN_PREFETCH_* bits, 0 to disable.
+ * @distance: how many frames ahead of the one being processed to prefetch,
+ * 0 to disable.
+ * @iova2va: translation for FD addresses, NULL if they are virtual addresses.
+ *
+ * 'fqd_ctx' is always used as a virtual address.
+ *
+ * Return 0 for success, or -EINVAL for unknown flags.
+ */
+int qbman_swp_fd_prefetch_set(struct qbman_swp *s, uint32_t flags,
+			      uint32_t distance, qbman_iova_to_va_cb iova2va);
+
+/**
+ * qbman_swp_prefetch_fd() - Prefetch what a dequeue result's FD points to.
+ * @s: the software portal object.
+ * @dq: the dequeue result.
+ *
+ * Follows the qbman_swp_fd_prefetch_set() configuration. Does nothing for
+ * results which don't carry a valid frame. Typically called on dq[i + distance]
+ * while processing dq[i].
+ */
+void qbman_swp_prefetch_fd(struct qbman_swp *s, const struct qbman_result *dq);
+
+/**
+ * qbman_swp_prefetch_fd_window() - Advance the frame prefetch window of a
+ * burst.
+ * @s: the software portal object.
+ * @dq: the burst returned by qbman_swp_dqrr_next_burst().
+ * @num: the number of entries in @dq.
+ * @i: the index of the frame about to be processed.
+ *
+ * Prefetches the frame 'distance' entries after @dq[@i], if the burst has one,
+ * so that with one call per processed frame every frame of the burst past the
+ * first 'distance' is requested 'distance' frames ahead of its use.
+ */
+void qbman_swp_prefetch_fd_window(struct qbman_swp *s,
+				  const struct qbman_result **dq,
+				  int num, int i);
+
 /**
  * qbman_swp_dqrr_consume() -  Consume DQRR entries previously returned from
  * qbman_swp_dqrr_next().
@@ -444,6 +629,15 @@ void qbman_swp_dqrr_consume(struct qbman_swp *s, const struct qbman_result *dq);
  */
 void qbman_swp_dqrr_idx_consume(struct qbman_swp *s, uint8_t dqrr_index);
 
+/**
+ * qbman_swp_dqrr_idx_consume_mask() - Consume a set of DQRR entries
+ * @s: the software portal object.
+ * @mask: bit n set to consume the DQRR entry of index n.
+ *
+ * The entries are consumed one DCAP write each, issued back to back.
+ */
+void qbman_swp_dqrr_idx_consume_mask(struct qbman_swp *s, uint16_t mask);
+
 /**
  * qbman_get_dqrr_idx() - Get dqrr index from the given dqrr
  * @dqrr: the given dqrr object.
@@ -598,6 +792,86 @@ int qbman_result_is_FQRNI(const struct qbman_result *dq);
  */
 int qbman_result_is_FQPN(const struct qbman_result *dq);
 
+/* Rather than testing each result against every qbman_result_is_***() in
+ * turn, results can be dispatched to per-type handlers through a table
+ * indexed by the response verb.
+ */
+enum qbman_result_type {
+	qbman_result_type_dq,
+	qbman_result_type_fqdan,
+	qbman_result_type_cdan,
+	qbman_result_type_cscn,
+	qbman_result_type_bpscn,
+	qbman_result_type_cgcu,
+	qbman_result_type_fqrn,
+	qbman_result_type_fqrni,
+	qbman_result_type_fqpn
+};
+
+/**
+ * typedef qbman_result_handler - Handler for one type of result
+ * @ctx: the context registered with the handler.
+ * @s: the software portal given to qbman_result_dispatch_burst().
+ * @dq: the result, the handler is responsible for consuming it if needed.
+ */
+typedef void (*qbman_result_handler)(void *ctx, struct qbman_swp *s,
+				     const struct qbman_result *dq);
+
+#define QBMAN_RESULT_DISPATCH_SIZE 128
+
+/**
+ * struct qbman_result_dispatch - verb-indexed table of result handlers
+ *
+ * Instantiated by the caller and set up with qbman_result_dispatch_init() and
+ * qbman_result_dispatch_register(), not to be manipulated directly.
+ */
+struct qbman_result_dispatch {
+	struct {
+		qbman_result_handler handler;
+		void *ctx;
+	} tbl[QBMAN_RESULT_DISPATCH_SIZE];
+};
+
+/**
+ * qbman_result_dispatch_init() - Point every verb at the same handler
+ * @t: the dispatch table.
+ * @handler: the handler for results of unregistered types, may be NULL to
+ * skip those.
+ * @ctx: passed to @handler.
+ */
+void qbman_result_dispatch_init(struct qbman_result_dispatch *t,
+				qbman_result_handler handler, void *ctx);
+
+/**
+ * qbman_result_dispatch_register() - Set the handler for one type of result
+ * @t: the dispatch table.
+ * @type: the result type, qbman_result_type_cscn covers both the memory and
+ * WQ flavours of CSCN.
+ * @handler: the handler, or NULL to skip results of this type.
+ * @ctx: passed to @handler.
+ *
+ * Return 0 for success, -EINVAL for an unknown type.
+ */
+int qbman_result_dispatch_register(struct qbman_result_dispatch *t,
+				   enum qbman_result_type type,
+				   qbman_result_handler handler, void *ctx);
+
+/**
+ * qbman_result_dispatch_burst() - Hand a burst of results to their handlers
+ * @t: the dispatch table.
+ * @s: the software portal the results came from, passed to the handlers.
+ * @dq: the results, from DQRR or user-provided storage.
+ * @num: the number of results.
+ *
+ * Frame dequeue results are checked for inline ahead of the table lookup.
+ *
+ * Return the number of results passed to a handler.
+ */
+int qbman_result_dispatch_burst(const struct qbman_result_dispatch *t,
+				struct qbman_swp *s,
+				const struct qbman_result **dq,
+				int num);
+
 /* Parsing frame dequeue results (qbman_result_is_DQ() must be TRUE)
  */
 /* FQ empty */
@@ -709,6 +983,43 @@ uint64_t qbman_result_DQ_fqd_ctx(const struct qbman_result *dq);
  */
 const struct qbman_fd *qbman_result_DQ_fd(const struct qbman_result *dq);
 
+/**
+ * struct qbman_dq_meta - frame metadata arrays filled by
+ * qbman_result_DQ_decode_burst()
+ * @addr: buffer address, addr_hi:addr_lo of the FD.
+ * @len: frame length.
+ * @bpid: buffer pool id.
+ * @offset: offset of the frame data in the buffer.
+ * @fqd_ctx: the frame queue context, see qbman_result_DQ_fqd_ctx().
+ * @stat: the STAT field, see qbman_result_DQ_flags().
+ *
+ * All arrays are provided by the caller and must hold as many entries as the
+ * burst being decoded.
+ */
+struct qbman_dq_meta {
+	uint64_t *addr;
+	uint32_t *len;
+	uint16_t *bpid;
+	uint16_t *offset;
+	uint64_t *fqd_ctx;
+	uint8_t *stat;
+};
+
+/**
+ * qbman_result_DQ_decode_burst() - Decode a burst of dequeue results into
+ * struct-of-arrays frame metadata.
+ * @dq: the dequeue results, qbman_result_is_DQ() must be TRUE for all of them.
+ * @num: the number of results.
+ * @m: the arrays to fill, entry i describes @dq[i].
+ *
+ * Reads each result's cacheline once instead of going through
+ * qbman_result_DQ_fd() and friends per frame. Uses NEON on little-endian
+ * ARMv8. Once decoded, DQRR entries not needed for DCA can be consumed straight
+ * away.
+ */
+void qbman_result_DQ_decode_burst(const struct qbman_result **dq, int num,
+				  const struct qbman_dq_meta *m);
+
 /* State-change notifications (FQDAN/CDAN/CSCN/...). */
 
 /**
@@ -811,6 +1122,43 @@ uint16_t qbman_result_cgcu_cgid(const struct qbman_result *scn);
  */
 uint64_t qbman_result_cgcu_icnt(const struct qbman_result *scn);
 
+/* Parsing enqueue responses, written to the storage given to
+ * qbman_eq_desc_set_response() and read through a "struct qbman_result".
+ */
+
+/**
+ * qbman_result_eqresp_fd() - Get the frame descriptor of an enqueue response
+ * @eqresp: the enqueue response.
+ *
+ * Return the frame descriptor that was enqueued.
+ */
+const struct qbman_fd *
+qbman_result_eqresp_fd(const struct qbman_result *eqresp);
+
+/**
+ * qbman_result_eqresp_set_rspid() - Set the token of an enqueue response
+ * @eqresp: the enqueue response.
+ * @val: the token, 0 so that the next response written can be detected.
+ */
+void qbman_result_eqresp_set_rspid(struct qbman_result *eqresp, uint8_t val);
+
+/**
+ * qbman_result_eqresp_rspid() - Get the token of an enqueue response
+ * @eqresp: the enqueue response.
+ *
+ * Return the token set by qbman_eq_desc_set_token(), non-zero once the
+ * response has been written.
+ */
+uint8_t qbman_result_eqresp_rspid(const struct qbman_result *eqresp);
+
+/**
+ * qbman_result_eqresp_rc() - Get the response code of an enqueue response
+ * @eqresp: the enqueue response.
+ *
+ * Return 0 if the frame was enqueued, or the non-zero reason it was rejected.
+ */
+uint8_t qbman_result_eqresp_rc(const struct qbman_result *eqresp);
+
 	/************/
 	/* Enqueues */
 	/************/
@@ -1026,6 +1374,152 @@ int qbman_swp_enqueue_multiple_desc(struct qbman_swp *s,
 				    const struct qbman_fd *fd,
 				    int num_frames);
 
+/**
+ * qbman_swp_enqueue_burst() - Enqueue a burst larger than the EQCR
+ * @s: the software portal used for enqueue.
+ * @d: the enqueue descriptor.
+ * @fd: the frame descriptors to be enqueued.
+ * @flags: bit-mask of QBMAN_ENQUEUE_FLAG_*** options per frame, or NULL.
+ * @num_frames: the number of the frames to be enqueued, may exceed the
+ * EQCR size.
+ * @budget: how long to keep retrying once the EQCR is full, in
+ * read_free_running_frequency_counter() ticks. 0 returns as soon as the ring
+ * is full.
+ *
+ * Streams @fd through the EQCR with qbman_swp_enqueue_multiple(), one chunk per
+ * ring's worth of free space, re-reading the consumer index between chunks.
+ * Frames are accepted strictly in order, so on return @fd[0] to
+ * @fd[ret - 1] have been enqueued and the rest have not. Any doorbell deferred
+ * with qbman_swp_enqueue_doorbell_set() is rung before returning.
+ *
+ * Return the number of frames enqueued.
+ */
+int qbman_swp_enqueue_burst(struct qbman_swp *s,
+			    const struct qbman_eq_desc *d,
+			    const struct qbman_fd *fd,
+			    uint32_t *flags,
+			    int num_frames,
+			    uint64_t budget);
+
+/**
+ * typedef qbman_swp_forward_cb - Per-frame hook for qbman_swp_forward_burst()
+ * @ctx: the caller context given to qbman_swp_forward_burst().
+ * @dq: the dequeue result being forwarded.
+ * @fd: a copy of the dequeued frame descriptor, which may be modified and is
+ * what gets enqueued.
+ * @fqid: returns the frame queue to enqueue to.
+ *
+ * Return 0 to forward the frame, non-zero to drop it. A dropped frame's DQRR
+ * entry is consumed, the buffer is left to the callback.
+ */
+typedef int (*qbman_swp_forward_cb)(void *ctx, const struct qbman_result *dq,
+				    struct qbman_fd *fd, uint32_t *fqid);
+
+/**
+ * qbman_swp_forward_burst() - Enqueue dequeued frames with DCA
+ * @s: the software portal the frames were dequeued from and enqueued to.
+ * @d: the enqueue descriptor template, its target and DCA settings are
+ * overridden per frame.
+ * @dq: DQRR entries returned by qbman_swp_dqrr_next() on @s, not yet consumed.
+ * Results in user-provided storage cannot be used here.
+ * @num_frames: the number of entries in @dq.
+ * @cb: picks the target FQ and optionally rewrites the FD for each frame.
+ * @ctx: passed through to @cb.
+ *
+ * Each forwarded frame is enqueued with discrete consumption acknowledgement
+ * of its own DQRR entry, so hardware consumes the entry (releasing a
+ * held-active FQ) once the enqueue is done, with no separate DCAP write.
+ *
+ * Return the number of entries handled, forwarded or dropped. Entries from
+ * @dq[ret] onwards are untouched, because the EQCR was full, and may be passed
+ * in again later; @cb can see those frames again.
+ */
+int qbman_swp_forward_burst(struct qbman_swp *s,
+			    const struct qbman_eq_desc *d,
+			    const struct qbman_result **dq,
+			    int num_frames,
+			    qbman_swp_forward_cb cb,
+			    void *ctx);
+
+/**
+ * qbman_swp_enqueue_backlog_set() - Size the portal's software enqueue backlog
+ * @s: the software portal used for enqueue.
+ * @depth: number of frames the backlog can hold, rounded up to a power of 2.
+ * 0 disables the backlog.
+ *
+ * When enabled, frames that qbman_swp_enqueue(), qbman_swp_enqueue_multiple()
+ * or qbman_swp_enqueue_multiple_desc() cannot place in a full EQCR are copied
+ * to the backlog and counted as enqueued. The backlog is drained in order, as
+ * EQCR space frees up, at the start of each subsequent enqueue call and each
+ * qbman_swp_dqrr_next() or qbman_result_has_new_result() poll; new frames are
+ * never written to EQCR ahead of older backlogged ones. Frames with
+ * QBMAN_ENQUEUE_FLAG_DCA keep their DQRR entry unconsumed until they reach
+ * the EQCR.
+ *
+ * Return 0 for success, -EBUSY if the backlog currently holds frames, -EINVAL
+ * if @depth is too large, or -ENOMEM.
+ */
+int qbman_swp_enqueue_backlog_set(struct qbman_swp *s, unsigned int depth);
+
+/**
+ * qbman_swp_enqueue_backlog_flush() - Move backlogged frames onto the EQCR
+ * @s: the software portal used for enqueue.
+ *
+ * Return the number of frames still held in the backlog.
+ */
+int qbman_swp_enqueue_backlog_flush(struct qbman_swp *s);
+
+/**
+ * qbman_swp_enqueue_backlog_depth() - Get the number of backlogged frames
+ * @s: the software portal used for enqueue.
+ */
+unsigned int qbman_swp_enqueue_backlog_depth(struct qbman_swp *s);
+
+/**
+ * qbman_swp_enqueue_ci_refresh_set() - Set the EQCR consumer index
+ * low-watermark
+ * @s: the software portal used for enqueue.
+ * @thresh: between 1 and the EQCR size (8, or 32 on memory-backed portals).
+ *
+ * The driver tracks free EQCR space from a cached copy of the consumer index.
+ * While the cached free space is below @thresh, an enqueue call asking for more
+ * frames than are known to fit re-reads CI before writing. With the default of
+ * 1, CI is only read once the ring looks full, which can cut a burst short; a
+ * higher watermark lets a large qbman_swp_enqueue_multiple() use the whole ring
+ * in one call, and also has the CI cacheline prefetched after each enqueue
+ * while the free space is below it.
+ *
+ * Return 0 for success, -EINVAL if @thresh is out of range.
+ */
+int qbman_swp_enqueue_ci_refresh_set(struct qbman_swp *s, unsigned int thresh);
+
+/**
+ * qbman_swp_enqueue_doorbell_set() - Defer the EQCR_PI doorbell
+ * @s: the software portal used for enqueue.
+ * @thresh: ring the doorbell once this many frames are pending, 0 to ring it
+ * on every enqueue call (the default). Must not exceed the EQCR size.
+ * @budget: if non-zero, also ring the doorbell once frames have been pending
+ * for this many read_free_running_frequency_counter() ticks.
+ *
+ * Only applies to memory-backed portals, where enqueued frames become visible
+ * to hardware when the producer index is written to EQCR_PI. With deferral
+ * enabled, enqueue calls only fill EQCR entries and the barrier and doorbell
+ * write are shared by all frames pending at that point. The budget is checked
+ * on enqueue and qbman_swp_dqrr_next() calls, so a producer that may go idle
+ * should call qbman_swp_enqueue_doorbell_flush().
+ *
+ * Return 0 for success, -ENOTSUP if the portal is not memory-backed, or
+ * -EINVAL if @thresh is too large.
+ */
+int qbman_swp_enqueue_doorbell_set(struct qbman_swp *s, unsigned int thresh,
+				   uint64_t budget);
+
+/**
+ * qbman_swp_enqueue_doorbell_flush() - Ring any deferred EQCR_PI doorbell
+ * @s: the software portal used for enqueue.
+ */
+void qbman_swp_enqueue_doorbell_flush(struct qbman_swp *s);
+
 /* TODO:
  * qbman_swp_enqueue_thresh() - Set threshold for EQRI interrupt.
  * @s: the software portal.
@@ -0,0 +1,429 @@
+/* Copyright 2026 NXP
+ *
+ * SPDX-License-Identifier:        BSD-3-Clause
+ */
+
+#ifndef _FSL_QBMAN_SCHED_H
+#define _FSL_QBMAN_SCHED_H
+
+#include <fsl_qbman_portal.h>
+
+/* ------------------------------- */
+/* Software push (SDQCR) scheduler */
+/* ------------------------------- */
+
+/* The push scheduler manages some of the 16 push channel indices of a portal.
+ * Every qbman_push_sched_run() it looks at the last known backlog of each
+ * managed channel: while channels of a given priority have frames waiting,
+ * lower priority channels are taken out of the SDQCR, but never for more than
+ * their 'max_starve' runs in a row. Channel indices not added to the scheduler
+ * keep whatever qbman_swp_push_set() gave them.
+ */
+struct qbman_push_sched;
+
+/* Priorities go from 0 (highest) to QBMAN_PUSH_SCHED_PRIO_MAX (lowest) */
+#define QBMAN_PUSH_SCHED_PRIO_MAX 7
+
+/**
+ * qbman_push_sched_create() - Create a push scheduler for a portal.
+ * @s: the software portal object.
+ *
+ * Return the scheduler, or NULL on failure.
+ */
+struct qbman_push_sched *qbman_push_sched_create(struct qbman_swp *s);
+
+/**
+ * qbman_push_sched_destroy() - Free a push scheduler, the SDQCR is left as is.
+ * @ps: the push scheduler.
+ */
+void qbman_push_sched_destroy(struct qbman_push_sched *ps);
+
+/**
+ * qbman_push_sched_add() - Put a push channel under the scheduler control.
+ * @ps: the push scheduler.
+ * @channel_idx: the channel index (0 to 15) of the portal.
+ * @chanid: the channel id, used by qbman_push_sched_refresh().
+ * @prio: the channel priority.
+ * @max_starve: how many runs in a row the channel may be disabled while it
+ * has a backlog, 0 to never disable it.
+ *
+ * Return 0 for success, or -EINVAL for an invalid index or priority.
+ */
+int qbman_push_sched_add(struct qbman_push_sched *ps, uint8_t channel_idx,
+			 uint16_t chanid, uint8_t prio, uint32_t max_starve);
+
+/**
+ * qbman_push_sched_remove() - Give a push channel back to the caller.
+ * @ps: the push scheduler.
+ * @channel_idx: the channel index, its SDQCR bit is left as is.
+ *
+ * Return 0 for success, or -EINVAL if the channel is not managed.
+ */
+int qbman_push_sched_remove(struct qbman_push_sched *ps, uint8_t channel_idx);
+
+/**
+ * qbman_push_sched_set_backlog() - Report the backlog of a channel.
+ * @ps: the push scheduler.
+ * @channel_idx: the channel index.
+ * @frames: the number of frames waiting on the channel.
+ *
+ * For callers that track backlog themselves, e.g. from the frame counts of
+ * dequeue results, instead of qbman_push_sched_refresh().
+ */
+void qbman_push_sched_set_backlog(struct qbman_push_sched *ps,
+				  uint8_t channel_idx, uint32_t frames);
+
+/**
+ * qbman_push_sched_refresh() - Read the backlog of all managed channels.
+ * @ps: the push scheduler.
+ *
+ * Issues a WQ channel query management command per managed channel.
+ *
+ * Return 0 for success, or the error of the first failed query.
+ */
+int qbman_push_sched_refresh(struct qbman_push_sched *ps);
+
+/**
+ * qbman_push_sched_run() - Apply the scheduling policy.
+ * @ps: the push scheduler.
+ *
+ * The SDQCR is only written if the set of enabled channels changes.
+ *
+ * Return the push channel mask now in effect.
+ */
+uint16_t qbman_push_sched_run(struct qbman_push_sched *ps);
+
+/* -------------------- */
+/* Adaptive pull sizing */
+/* -------------------- */
+
+/**
+ * struct qbman_pull_adapt - Per-FQ pull size controller
+ * @numframes: the number of frames to ask for in the next pull.
+ * @max_frames: upper bound of @numframes, bounds the time a single pull
+ * holds the portal.
+ * @got: frames returned so far by the current pull.
+ * @pulls: completed pulls.
+ * @frames: frames returned by all pulls.
+ * @empty_pulls: pulls that returned no frame.
+ * @grows: times @numframes was raised.
+ * @shrinks: times @numframes was lowered.
+ *
+ * Fed with every result of the FQ's pulls. A pull that comes back full while
+ * the FQ still holds frames doubles @numframes, up to @max_frames; a pull that
+ * drains the FQ brings @numframes down to what it returned, so light FQs stop
+ * asking for frames that are not there. @frames / @pulls is the yield per
+ * command.
+ */
+struct qbman_pull_adapt {
+	uint8_t numframes;
+	uint8_t max_frames;
+	uint8_t got;
+	uint64_t pulls;
+	uint64_t frames;
+	uint64_t empty_pulls;
+	uint64_t grows;
+	uint64_t shrinks;
+};
+
+/**
+ * qbman_pull_adapt_init() - Initialise a pull size controller.
+ * @a: the controller.
+ * @max_frames: the upper bound of the pull size, 1 to 16.
+ *
+ * The first pull asks for a single frame.
+ */
+void qbman_pull_adapt_init(struct qbman_pull_adapt *a, uint8_t max_frames);
+
+/**
+ * qbman_pull_adapt_update() - Account a result of the FQ's current pull.
+ * @a: the controller.
+ * @dq: a volatile dequeue result.
+ *
+ * Return 1 if @dq completes the pull (@numframes is then updated), 0
+ * otherwise.
+ */
+int qbman_pull_adapt_update(struct qbman_pull_adapt *a,
+			    const struct qbman_result *dq);
+
+/* ------------------------------------- */
+/* Deficit round robin volatile dequeues */
+/* ------------------------------------- */
+
+/* The pull scheduler owns a set of FQs, each with a weight, and serves them in
+ * deficit round robin order through volatile dequeues to DQRR: every visit
+ * gives an FQ 'weight * quantum' bytes of credit, and the lengths of the frames
+ * it returns are charged against it. An FQ reported empty is skipped for
+ * 'idle_rounds' rounds, or until qbman_pull_sched_wake(). Only one pull is
+ * outstanding at a time; the next one is issued as soon as the previous one
+ * expires, from qbman_pull_sched_account(). The size of each pull is chosen
+ * per FQ by a struct qbman_pull_adapt.
+ */
+struct qbman_pull_sched;
+
+/**
+ * qbman_pull_sched_create() - Create a pull scheduler for a portal.
+ * @s: the software portal object, its VDQCR is owned by the scheduler.
+ * @max_fqs: the number of FQs that can be added.
+ * @quantum: the byte credit per round of an FQ of weight 1.
+ * @idle_rounds: how many rounds an empty FQ is skipped before it is pulled
+ * again.
+ *
+ * Return the scheduler, or NULL on failure.
+ */
+struct qbman_pull_sched *qbman_pull_sched_create(struct qbman_swp *s,
+						 uint32_t max_fqs,
+						 uint32_t quantum,
+						 uint32_t idle_rounds);
+
+/**
+ * qbman_pull_sched_destroy() - Free a pull scheduler.
+ * @ps: the pull scheduler, no pull may be outstanding.
+ */
+void qbman_pull_sched_destroy(struct qbman_pull_sched *ps);
+
+/**
+ * qbman_pull_sched_add() - Add an FQ.
+ * @ps: the pull scheduler.
+ * @fqid: the frame queue id.
+ * @weight: the relative share of the FQ, at least 1.
+ *
+ * Return the handle of the FQ in the scheduler (>= 0), -EINVAL for a zero
+ * weight, or -ENOSPC if the scheduler is full.
+ */
+int qbman_pull_sched_add(struct qbman_pull_sched *ps, uint32_t fqid,
+			 uint32_t weight);
+
+/**
+ * qbman_pull_sched_remove() - Remove an FQ.
+ * @ps: the pull scheduler.
+ * @handle: the value returned by qbman_pull_sched_add().
+ *
+ * Return 0 for success, or -EINVAL for an unknown handle.
+ */
+int qbman_pull_sched_remove(struct qbman_pull_sched *ps, int handle);
+
+/**
+ * qbman_pull_sched_set_max_frames() - Bound the pull size of an FQ.
+ * @ps: the pull scheduler.
+ * @handle: the value returned by qbman_pull_sched_add().
+ * @max_frames: 1 to 16, 16 by default.
+ *
+ * Pull sizes are picked per FQ by a struct qbman_pull_adapt controller.
+ *
+ * Return 0 for success, or -EINVAL for an unknown handle or invalid bound.
+ */
+int qbman_pull_sched_set_max_frames(struct qbman_pull_sched *ps, int handle,
+				    uint8_t max_frames);
+
+/**
+ * qbman_pull_sched_adapt() - Get the pull size controller of an FQ.
+ * @ps: the pull scheduler.
+ * @handle: the value returned by qbman_pull_sched_add().
+ *
+ * Return the controller, for its counters.
+ */
+const struct qbman_pull_adapt *qbman_pull_sched_adapt(
+			const struct qbman_pull_sched *ps, int handle);
+
+/**
+ * qbman_pull_sched_wake() - Mark an FQ as having frames, e.g. on FQDAN.
+ * @ps: the pull scheduler.
+ * @handle: the value returned by qbman_pull_sched_add().
+ */
+void qbman_pull_sched_wake(struct qbman_pull_sched *ps, int handle);
+
+/**
+ * qbman_pull_sched_issue() - Issue the next pull if the VDQCR is free.
+ * @ps: the pull scheduler.
+ *
+ * Needed to start the scheduler, and again whenever qbman_pull_sched_account()
+ * found nothing to pull.
+ *
+ * Return 1 if a pull was issued, 0 otherwise.
+ */
+int qbman_pull_sched_issue(struct qbman_pull_sched *ps);
+
+/**
+ * qbman_pull_sched_account() - Feed a DQRR result to the scheduler.
+ * @ps: the pull scheduler.
+ * @dq: the result, from qbman_swp_dqrr_next().
+ *
+ * Results other than volatile dequeues are ignored, so every DQRR entry of the
+ * portal can be passed in. Issues the next pull when the outstanding one
+ * expires.
+ */
+void qbman_pull_sched_account(struct qbman_pull_sched *ps,
+			      const struct qbman_result *dq);
+
+/* ----------------------------------- */
+/* Work stealing across worker portals */
+/* ----------------------------------- */
+
+/* A steal group is shared by workers that each own a portal and a set of FQs.
+ * Owners publish the backlog of their FQs, either from the frame counts of
+ * their dequeue results or through qbman_steal_refresh(); an idle worker then
+ * calls qbman_steal() to pull, on its own portal, from the most backlogged FQ
+ * of a peer. FQs added with QBMAN_STEAL_FQ_ORDERED, and FQs last seen held
+ * active, are never stolen, so ordering and DCA guarantees are left to their
+ * owner. At most one thief pulls from a given FQ at a time.
+ *
+ * Workers and FQs are added before the workers start; the other calls are
+ * safe to make concurrently from different workers, each passing its own
+ * worker id as @self.
+ */
+struct qbman_steal_group;
+
+/* The FQ relies on its owner for order preservation, don't steal from it */
+#define QBMAN_STEAL_FQ_ORDERED 0x1
+
+/**
+ * qbman_steal_group_create() - Create a steal group.
+ * @max_workers: the number of workers.
+ * @max_fqs: the number of FQs per worker.
+ * @min_backlog: the backlog, in frames, an FQ needs to be worth stealing from.
+ *
+ * Return the group, or NULL on failure.
+ */
+struct qbman_steal_group *qbman_steal_group_create(uint32_t max_workers,
+						   uint32_t max_fqs,
+						   uint32_t min_backlog);
+
+/**
+ * qbman_steal_group_destroy() - Free a steal group.
+ * @sg: the steal group.
+ */
+void qbman_steal_group_destroy(struct qbman_steal_group *sg);
+
+/**
+ * qbman_steal_worker_add() - Add a worker.
+ * @sg: the steal group.
+ * @s: the worker's software portal, used for the pulls it steals.
+ *
+ * Return the worker id (>= 0), or -ENOSPC if the group is full.
+ */
+int qbman_steal_worker_add(struct qbman_steal_group *sg, struct qbman_swp *s);
+
+/**
+ * qbman_steal_fq_add() - Add an FQ owned by a worker.
+ * @sg: the steal group.
+ * @worker: the owner's worker id.
+ * @fqid: the frame queue id.
+ * @flags: QBMAN_STEAL_FQ_* flags.
+ *
+ * Return the FQ handle within the worker (>= 0), -EINVAL for an unknown
+ * worker, or -ENOSPC if the worker has no room left.
+ */
+int qbman_steal_fq_add(struct qbman_steal_group *sg, int worker, uint32_t fqid,
+		       uint32_t flags);
+
+/**
+ * qbman_steal_set_backlog() - Publish the backlog of an FQ.
+ * @sg: the steal group.
+ * @worker: the owner's worker id.
+ * @fq: the FQ handle.
+ * @frames: frames waiting, e.g. qbman_result_DQ_frame_count() of the last
+ * result dequeued from the FQ.
+ */
+void qbman_steal_set_backlog(struct qbman_steal_group *sg, int worker, int fq,
+			     uint32_t frames);
+
+/**
+ * qbman_steal_refresh() - Query the backlog and state of a worker's FQs.
+ * @sg: the steal group.
+ * @self: the calling worker, whose portal issues the queries.
+ * @worker: the worker whose FQs are queried.
+ *
+ * Return 0 for success, or the error of the first failed query.
+ */
+int qbman_steal_refresh(struct qbman_steal_group *sg, int self, int worker);
+
+/**
+ * qbman_steal() - Pull from the most backlogged FQ of a peer.
+ * @sg: the steal group.
+ * @self: the calling, idle, worker.
+ *
+ * The frames arrive in the DQRR of the caller's portal and are passed to
+ * qbman_steal_account() like any other result.
+ *
+ * Return 1 if a pull was issued, 0 if there was nothing worth stealing, a
+ * stolen pull is still outstanding or the portal was busy.
+ */
+int qbman_steal(struct qbman_steal_group *sg, int self);
+
+/**
+ * qbman_steal_account() - Feed a DQRR result of the caller's portal.
+ * @sg: the steal group.
+ * @self: the calling worker.
+ * @dq: the result.
+ *
+ * Releases the stolen FQ and updates its backlog once the pull expires.
+ * Results of other dequeues are ignored.
+ */
+void qbman_steal_account(struct qbman_steal_group *sg, int self,
+			 const struct qbman_result *dq);
+
+/* -------------------- */
+/* Multi-portal polling */
+/* -------------------- */
+
+/* A poll group lets one thread service several portals. Each poll first checks
+ * the next DQRR valid-bit of every member, then harvests the members that have
+ * entries, round-robin from a rotating start and up to each member's burst
+ * cap, into one burst where every entry is tagged with its member index.
+ */
+struct qbman_poll_group;
+
+/**
+ * qbman_poll_group_create() - Create a poll group.
+ * @max_portals: the number of portals that can be added.
+ *
+ * Return the poll group, or NULL on failure.
+ */
+struct qbman_poll_group *qbman_poll_group_create(uint32_t max_portals);
+
+/**
+ * qbman_poll_group_destroy() - Free a poll group, the portals are left as is.
+ * @pg: the poll group.
+ */
+void qbman_poll_group_destroy(struct qbman_poll_group *pg);
+
+/**
+ * qbman_poll_group_add() - Add a portal.
+ * @pg: the poll group.
+ * @s: the software portal object.
+ * @burst_cap: the most entries taken from @s per poll, at least 1.
+ *
+ * Return the member index (>= 0), -EINVAL for a zero cap, or -ENOSPC if the
+ * group is full.
+ */
+int qbman_poll_group_add(struct qbman_poll_group *pg, struct qbman_swp *s,
+			 uint32_t burst_cap);
+
+/**
+ * qbman_poll_group_swp() - Get the portal of a member.
+ * @pg: the poll group.
+ * @idx: the member index.
+ *
+ * Return the software portal object.
+ */
+struct qbman_swp *qbman_poll_group_swp(const struct qbman_poll_group *pg,
+				       uint16_t idx);
+
+/**
+ * qbman_poll_group_poll() - Harvest DQRR entries of all members.
+ * @pg: the poll group.
+ * @dq: array receiving the entries.
+ * @src: array receiving the member index of each entry.
+ * @num: the size of @dq and @src.
+ *
+ * Entries are consumed through the portal of their member, see
+ * qbman_poll_group_swp().
+ *
+ * Return the number of entries stored in @dq.
+ */
+int qbman_poll_group_poll(struct qbman_poll_group *pg,
+			  const struct qbman_result **dq, uint16_t *src,
+			  int num);
+
+#endif /* !_FSL_QBMAN_SCHED_H */
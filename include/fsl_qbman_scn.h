@@ -0,0 +1,329 @@
+/* Copyright 2026 NXP
+ *
+ * SPDX-License-Identifier:        BSD-3-Clause
+ */
+
+#ifndef _FSL_QBMAN_SCN_H
+#define _FSL_QBMAN_SCN_H
+
+#include <fsl_qbman_portal.h>
+
+/* ----------------------- */
+/* CGR congestion tracking */
+/* ----------------------- */
+
+/* Congestion state of CGRs, as last reported by CSCN, whether those are
+ * written to memory or dequeued from a WQ. One thread feeds the notifications
+ * with qbman_cgr_cache_update(), producers on any thread check the state of
+ * the CGR they are about to enqueue to with qbman_cgr_is_congested() and drop,
+ * divert or hold back frames that QMan would reject anyway. CGRs start out not
+ * congested.
+ */
+struct qbman_cgr_cache {
+	uint32_t num_cgids;
+	volatile uint8_t *congested; /* indexed by CGID */
+};
+
+/* CSCN state bit: the CGR is congested */
+#define QBMAN_CSCN_STATE_CONGESTED 0x1
+
+/**
+ * qbman_cgr_cache_create() - Create a congestion state cache.
+ * @num_cgids: CGIDs from 0 to @num_cgids - 1 are tracked.
+ *
+ * Return the cache, or NULL on failure.
+ */
+struct qbman_cgr_cache *qbman_cgr_cache_create(uint32_t num_cgids);
+
+/**
+ * qbman_cgr_cache_destroy() - Free a congestion state cache.
+ * @cc: the cache.
+ */
+void qbman_cgr_cache_destroy(struct qbman_cgr_cache *cc);
+
+/**
+ * qbman_cgr_cache_update() - Apply a state-change notification.
+ * @cc: the cache.
+ * @scn: the notification, from DQRR, storage, or the CSCN write address of the
+ * CGR.
+ *
+ * Return 1 if @scn is a CSCN of a tracked CGR, 0 if it was ignored.
+ */
+int qbman_cgr_cache_update(struct qbman_cgr_cache *cc,
+			   const struct qbman_result *scn);
+
+/**
+ * qbman_cgr_is_congested() - Check the congestion state of a CGR.
+ * @cc: the cache.
+ * @cgid: the CGR id.
+ *
+ * Return non-zero if the last CSCN of @cgid reported it congested.
+ */
+static inline int qbman_cgr_is_congested(const struct qbman_cgr_cache *cc,
+					 uint16_t cgid)
+{
+	return cgid < cc->num_cgids && cc->congested[cgid];
+}
+
+/* ----------------------- */
+/* Buffer pool state table */
+/* ----------------------- */
+
+/* State of buffer pools, as last reported by BPSCN or read with
+ * qbman_bp_state_sync(). The state byte uses the BPSCN encoding. Acquire paths
+ * and per-core buffer caches check qbman_bp_has_bufs() before issuing
+ * qbman_swp_acquire(), and the callback lets a refill be started as soon as a
+ * pool enters depletion. Pools start out assumed to have buffers.
+ */
+struct qbman_bp_state;
+
+/* BPSCN state bits */
+#define QBMAN_BP_STATE_EMPTY	0x1 /* no free buffers */
+#define QBMAN_BP_STATE_DEPLETED	0x2 /* below the depletion entry threshold */
+#define QBMAN_BP_STATE_SURPLUS	0x4 /* above the surplus entry threshold */
+
+/**
+ * typedef qbman_bp_state_cb - Called when a pool enters or exits depletion
+ * @ctx: the context given to qbman_bp_state_create().
+ * @bpid: the buffer pool id.
+ * @state: the new QBMAN_BP_STATE_* bits.
+ */
+typedef void (*qbman_bp_state_cb)(void *ctx, uint16_t bpid, uint8_t state);
+
+struct qbman_bp_state {
+	uint32_t num_bpids;
+	volatile uint8_t *state; /* indexed by BPID */
+	qbman_bp_state_cb cb;
+	void *ctx;
+};
+
+/**
+ * qbman_bp_state_create() - Create a buffer pool state table.
+ * @num_bpids: BPIDs from 0 to @num_bpids - 1 are tracked.
+ * @cb: called on depletion changes, may be NULL.
+ * @ctx: passed back to @cb.
+ *
+ * Return the table, or NULL on failure.
+ */
+struct qbman_bp_state *qbman_bp_state_create(uint32_t num_bpids,
+					     qbman_bp_state_cb cb, void *ctx);
+
+/**
+ * qbman_bp_state_destroy() - Free a buffer pool state table.
+ * @bs: the table.
+ */
+void qbman_bp_state_destroy(struct qbman_bp_state *bs);
+
+/**
+ * qbman_bp_state_update() - Apply a state-change notification.
+ * @bs: the table.
+ * @scn: the notification.
+ *
+ * Return 1 if @scn is a BPSCN of a tracked pool, 0 if it was ignored.
+ */
+int qbman_bp_state_update(struct qbman_bp_state *bs,
+			  const struct qbman_result *scn);
+
+/**
+ * qbman_bp_state_sync() - Read the state of a pool with a BP query.
+ * @bs: the table.
+ * @s: the software portal issuing the query.
+ * @bpid: the buffer pool id.
+ *
+ * Return 0 for success, -EINVAL for an untracked pool, or the query error.
+ */
+int qbman_bp_state_sync(struct qbman_bp_state *bs, struct qbman_swp *s,
+			uint16_t bpid);
+
+/**
+ * qbman_bp_has_bufs() - Check whether a pool is worth acquiring from.
+ * @bs: the table.
+ * @bpid: the buffer pool id.
+ *
+ * Return non-zero unless the pool was last reported empty. Untracked pools
+ * are assumed to have buffers.
+ */
+static inline int qbman_bp_has_bufs(const struct qbman_bp_state *bs,
+				    uint16_t bpid)
+{
+	return bpid >= bs->num_bpids ||
+		!(bs->state[bpid] & QBMAN_BP_STATE_EMPTY);
+}
+
+/**
+ * qbman_bp_is_low() - Check whether a pool is depleted.
+ * @bs: the table.
+ * @bpid: the buffer pool id.
+ *
+ * Return non-zero if the pool was last reported depleted.
+ */
+static inline int qbman_bp_is_low(const struct qbman_bp_state *bs,
+				  uint16_t bpid)
+{
+	return bpid < bs->num_bpids &&
+		(bs->state[bpid] & QBMAN_BP_STATE_DEPLETED);
+}
+
+/**
+ * qbman_swp_acquire_checked() - qbman_swp_acquire() unless the pool is known
+ * to be empty.
+ * @s: the software portal object.
+ * @bs: the table.
+ * @bpid: the buffer pool id.
+ * @buffers: receives the buffer addresses.
+ * @num_buffers: the number of buffers to acquire, 1 to 7.
+ *
+ * Return the number of buffers acquired, -ENOBUFS without issuing a command
+ * if the pool is empty, or the qbman_swp_acquire() error.
+ */
+int qbman_swp_acquire_checked(struct qbman_swp *s,
+			      const struct qbman_bp_state *bs, uint16_t bpid,
+			      uint64_t *buffers, unsigned int num_buffers);
+
+/* ------------------------ */
+/* Software WRED early drop */
+/* ------------------------ */
+
+/* A WRED shadow holds the drop profiles of selected CGRs, loaded once with
+ * qbman_wred_shadow_load(), next to a cached instantaneous count of each CGR
+ * kept up to date from CGCU notifications or CGR queries. Producers call
+ * qbman_cgr_should_drop() to shed load in software with the same profile the
+ * hardware would apply, before paying for the EQCR write and the ERN.
+ */
+#define QBMAN_WRED_DP_NUM 7
+
+/* One drop precedence profile. A disabled profile has minth == maxth ==
+ * UINT64_MAX so that it never drops.
+ */
+struct qbman_wred_dp {
+	uint64_t minth;
+	uint64_t maxth;
+	uint64_t range; /* maxth - minth */
+	uint64_t maxp; /* drop probability at maxth, 2^32 scale, below 2^32 */
+};
+
+struct qbman_wred_cgr {
+	volatile uint64_t count;
+	struct qbman_wred_dp dp[QBMAN_WRED_DP_NUM];
+};
+
+struct qbman_wred_shadow {
+	uint32_t num_cgids;
+	struct qbman_wred_cgr **cgr; /* indexed by CGID, NULL if not loaded */
+};
+
+/**
+ * qbman_wred_shadow_create() - Create a WRED shadow.
+ * @num_cgids: CGIDs from 0 to @num_cgids - 1 can be loaded.
+ *
+ * Return the shadow, or NULL on failure.
+ */
+struct qbman_wred_shadow *qbman_wred_shadow_create(uint32_t num_cgids);
+
+/**
+ * qbman_wred_shadow_destroy() - Free a WRED shadow.
+ * @ws: the shadow.
+ */
+void qbman_wred_shadow_destroy(struct qbman_wred_shadow *ws);
+
+/**
+ * qbman_wred_shadow_load() - Load the WRED profiles and count of a CGR.
+ * @ws: the shadow.
+ * @s: the software portal issuing the WRED and CGR queries.
+ * @cgid: the CGR id.
+ *
+ * Return 0 for success, -EINVAL for an out of range CGID, -ENOMEM, or the
+ * query error.
+ */
+int qbman_wred_shadow_load(struct qbman_wred_shadow *ws, struct qbman_swp *s,
+			   uint16_t cgid);
+
+/**
+ * qbman_wred_shadow_refresh() - Re-read the instantaneous count of a CGR.
+ * @ws: the shadow.
+ * @s: the software portal issuing the CGR query.
+ * @cgid: a loaded CGR id.
+ *
+ * Return 0 for success, -EINVAL if @cgid is not loaded, or the query error.
+ */
+int qbman_wred_shadow_refresh(struct qbman_wred_shadow *ws,
+			      struct qbman_swp *s, uint16_t cgid);
+
+/**
+ * qbman_wred_shadow_update() - Apply a CGCU notification.
+ * @ws: the shadow.
+ * @scn: the notification.
+ *
+ * Return 1 if @scn is a CGCU of a loaded CGR, 0 if it was ignored.
+ */
+int qbman_wred_shadow_update(struct qbman_wred_shadow *ws,
+			     const struct qbman_result *scn);
+
+/**
+ * qbman_wred_rand() - Cheap per-thread random numbers for
+ * qbman_cgr_should_drop().
+ * @seed: the caller's state, any non-zero initial value.
+ *
+ * Return the next 32-bit value (xorshift32).
+ */
+static inline uint32_t qbman_wred_rand(uint32_t *seed)
+{
+	uint32_t x = *seed;
+
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	*seed = x;
+	return x;
+}
+
+/* a * b for b < 2^32, as hi * 2^32 + lo, in plain 64-bit arithmetic */
+static inline void qbman_wred_mul(uint64_t a, uint64_t b, uint64_t *hi,
+				  uint32_t *lo)
+{
+	uint64_t l = (a & 0xffffffff) * b;
+
+	*hi = (a >> 32) * b + (l >> 32);
+	*lo = (uint32_t)l;
+}
+
+/**
+ * qbman_cgr_should_drop() - Apply the cached WRED profile of a CGR.
+ * @ws: the shadow.
+ * @cgid: the CGR id.
+ * @color: the drop precedence, 0 to QBMAN_WRED_DP_NUM - 1.
+ * @seed: random state, see qbman_wred_rand().
+ *
+ * Below minth, the common case, this is a load and a compare. In between
+ * minth and maxth the frame is dropped with probability
+ * maxp * (count - minth) / (maxth - minth), computed in 96 bits so that it
+ * holds for byte-mode thresholds up to 2^40. An out of range @color never
+ * drops.
+ *
+ * Return non-zero if the frame should be dropped.
+ */
+static inline int qbman_cgr_should_drop(const struct qbman_wred_shadow *ws,
+					uint16_t cgid, uint8_t color,
+					uint32_t *seed)
+{
+	const struct qbman_wred_cgr *c;
+	const struct qbman_wred_dp *dp;
+	uint64_t cnt, ahi, bhi;
+	uint32_t alo, blo;
+
+	if (cgid >= ws->num_cgids || !ws->cgr[cgid] ||
+	    color >= QBMAN_WRED_DP_NUM)
+		return 0;
+	c = ws->cgr[cgid];
+	dp = &c->dp[color];
+	cnt = c->count;
+	if (cnt < dp->minth)
+		return 0;
+	if (cnt >= dp->maxth)
+		return 1;
+	qbman_wred_mul(cnt - dp->minth, dp->maxp, &ahi, &alo);
+	qbman_wred_mul(dp->range, qbman_wred_rand(seed), &bhi, &blo);
+	return ahi > bhi || (ahi == bhi && alo > blo);
+}
+
+#endif /* !_FSL_QBMAN_SCN_H */
@@ -0,0 +1,92 @@
+/* Copyright 2026 NXP
+ *
+ * SPDX-License-Identifier:        BSD-3-Clause
+ */
+
+#ifndef _FSL_QBMAN_SHAPER_H
+#define _FSL_QBMAN_SHAPER_H
+
+#include <fsl_qbman_portal.h>
+
+/* Software shaping.
+ *
+ * A shaper sits in front of a software portal and rate limits enqueues per
+ * target with token buckets, counting bytes from the FD length field. Frames
+ * within the rate go straight to the EQCR; over-rate frames are deferred in
+ * the target's queue, along with the time its head frame becomes eligible,
+ * and qbman_shaper_service() releases them in bursts once the bucket has
+ * refilled. A target is whatever the caller enqueues to through it, usually
+ * one FQ. The shaper belongs to the thread owning the portal, so there is no
+ * locking, and each call reads read_free_running_frequency_counter() once
+ * rather than once per frame.
+ */
+struct qbman_shaper;
+
+/**
+ * qbman_shaper_create() - Create a shaper.
+ * @s: the software portal frames are enqueued on.
+ * @max_targets: the number of targets that can be added.
+ * @queue_size: the number of frames each target can defer, a power of 2.
+ *
+ * Return the shaper, or NULL on failure, including when the frequency of
+ * read_free_running_frequency_counter() can't be read.
+ */
+struct qbman_shaper *qbman_shaper_create(struct qbman_swp *s,
+					 uint32_t max_targets,
+					 uint32_t queue_size);
+
+/**
+ * qbman_shaper_destroy() - Free a shaper.
+ * @sh: the shaper, deferred frames are dropped.
+ */
+void qbman_shaper_destroy(struct qbman_shaper *sh);
+
+/**
+ * qbman_shaper_target_add() - Add a shaped target.
+ * @sh: the shaper.
+ * @rate: the rate limit in bytes per second.
+ * @burst: the bucket depth in bytes, at least the largest frame.
+ *
+ * The bucket starts full.
+ *
+ * Return the target index, or -EINVAL for a zero rate or burst, or -ENOSPC
+ * if the shaper is full.
+ */
+int qbman_shaper_target_add(struct qbman_shaper *sh, uint64_t rate,
+			    uint32_t burst);
+
+/**
+ * qbman_shaper_enqueue() - Enqueue frames through a shaped target.
+ * @sh: the shaper.
+ * @target: the target index.
+ * @d: the enqueue descriptor, shared by the frames.
+ * @fd: the frame descriptors.
+ * @num: the number of frames.
+ *
+ * Frames within the rate are enqueued, the rest are deferred behind any frame
+ * the target already has deferred. A frame longer than the target's burst is
+ * never accepted, so the caller must drop it.
+ *
+ * Return the number of frames enqueued or deferred, less than @num if the
+ * target queue is full or @fd[ret] is longer than the burst.
+ */
+int qbman_shaper_enqueue(struct qbman_shaper *sh, int target,
+			 const struct qbman_eq_desc *d,
+			 const struct qbman_fd *fd, int num);
+
+/**
+ * qbman_shaper_service() - Release deferred frames that are now within rate.
+ * @sh: the shaper.
+ *
+ * Return the number of frames enqueued.
+ */
+int qbman_shaper_service(struct qbman_shaper *sh);
+
+/**
+ * qbman_shaper_deferred() - Get the number of frames a target has deferred.
+ * @sh: the shaper.
+ * @target: the target index.
+ */
+uint32_t qbman_shaper_deferred(const struct qbman_shaper *sh, int target);
+
+#endif /* !_FSL_QBMAN_SHAPER_H */
@@ -0,0 +1,252 @@
+/* Copyright 2026 NXP
+ *
+ * SPDX-License-Identifier:        BSD-3-Clause
+ */
+
+#ifndef _FSL_QBMAN_VPORTAL_H
+#define _FSL_QBMAN_VPORTAL_H
+
+#include <fsl_qbman_portal.h>
+
+/* Virtual portals.
+ *
+ * A mux wraps one software portal and hands out any number of virtual portals,
+ * one per thread. A virtual portal has an enqueue staging ring and a dequeue
+ * inbox, both single-producer/single-consumer rings shared with the thread
+ * that owns the software portal. That owner calls qbman_vportal_mux_service()
+ * in its loop: staged frames go to the EQCR in batches, and DQRR entries are
+ * copied to the inbox of the virtual portal picked by the route callback and
+ * consumed straight away. Entries are therefore never held in DQRR on behalf
+ * of a virtual portal, so DCA can't be used through one. When the target inbox
+ * is full the entry is left in DQRR and the mux stops dequeuing until there is
+ * room, which back-pressures the portal instead of dropping frames.
+ */
+struct qbman_vportal_mux;
+struct qbman_vportal;
+
+/**
+ * typedef qbman_vportal_route_cb - Pick the virtual portal of a DQRR entry
+ * @ctx: the context given to qbman_vportal_mux_create().
+ * @dq: the DQRR entry.
+ *
+ * Return the id of the target virtual portal (see qbman_vportal_id()), or a
+ * negative value to drop the entry. The buffer of a dropped single-buffer
+ * frame is released to its pool; an id that isn't an open virtual portal is
+ * counted as misrouted and dropped too.
+ */
+typedef int (*qbman_vportal_route_cb)(void *ctx, const struct qbman_result *dq);
+
+/**
+ * qbman_vportal_mux_create() - Create a mux over a software portal.
+ * @s: the software portal, only used by the mux owner from then on.
+ * @max_vportals: the number of virtual portals that can be opened.
+ * @ring_size: the size of each staging ring and inbox, a power of 2.
+ * @route: picks the virtual portal of each DQRR entry.
+ * @ctx: passed back to @route.
+ *
+ * Return the mux, or NULL on failure.
+ */
+struct qbman_vportal_mux *qbman_vportal_mux_create(struct qbman_swp *s,
+						   uint32_t max_vportals,
+						   uint32_t ring_size,
+						   qbman_vportal_route_cb route,
+						   void *ctx);
+
+/**
+ * qbman_vportal_mux_destroy() - Free a mux and its virtual portals.
+ * @mx: the mux.
+ */
+void qbman_vportal_mux_destroy(struct qbman_vportal_mux *mx);
+
+/**
+ * qbman_vportal_mux_service() - Move frames between the virtual portals and
+ * the software portal, called by the portal owner.
+ * @mx: the mux.
+ * @budget: the most DQRR entries to dequeue in this call.
+ *
+ * Return the number of frames enqueued plus entries dequeued.
+ */
+int qbman_vportal_mux_service(struct qbman_vportal_mux *mx, int budget);
+
+/**
+ * struct qbman_vportal_mux_stats - Frames a mux could not deliver
+ * @dropped: frames dropped by the route, their buffer released.
+ * @unreleased: dropped frames whose buffer could not be released, e.g.
+ * scatter/gather frames.
+ * @misrouted: entries routed to an id that isn't an open virtual portal.
+ */
+struct qbman_vportal_mux_stats {
+	uint64_t dropped;
+	uint64_t unreleased;
+	uint64_t misrouted;
+};
+
+/**
+ * qbman_vportal_mux_stats_get() - Read the mux counters.
+ * @mx: the mux.
+ * @st: returns the counters.
+ */
+void qbman_vportal_mux_stats_get(const struct qbman_vportal_mux *mx,
+				 struct qbman_vportal_mux_stats *st);
+
+/**
+ * qbman_vportal_open() - Open a virtual portal.
+ * @mx: the mux.
+ *
+ * Control path, not to be called concurrently with qbman_vportal_open() or
+ * qbman_vportal_mux_service().
+ *
+ * Return the virtual portal, or NULL if the mux is full.
+ */
+struct qbman_vportal *qbman_vportal_open(struct qbman_vportal_mux *mx);
+
+/**
+ * qbman_vportal_id() - Get the id of a virtual portal, as used for routing.
+ * @vp: the virtual portal.
+ *
+ * Return the id.
+ */
+int qbman_vportal_id(const struct qbman_vportal *vp);
+
+/**
+ * qbman_vportal_enqueue() - Stage frames for enqueue.
+ * @vp: the virtual portal.
+ * @d: the enqueue descriptors, one per frame.
+ * @fd: the frame descriptors.
+ * @num: the number of frames.
+ *
+ * Return the number of frames staged, less than @num if the staging ring is
+ * full.
+ */
+int qbman_vportal_enqueue(struct qbman_vportal *vp,
+			  const struct qbman_eq_desc *d,
+			  const struct qbman_fd *fd, int num);
+
+/**
+ * qbman_vportal_dequeue() - Take dequeue results from the inbox.
+ * @vp: the virtual portal.
+ * @dq: receives copies of the results.
+ * @num: the size of @dq.
+ *
+ * Return the number of results copied.
+ */
+int qbman_vportal_dequeue(struct qbman_vportal *vp, struct qbman_result *dq,
+			  int num);
+
+/* ------------ */
+/* Portal proxy */
+/* ------------ */
+
+/* A proxy lets threads without a portal of their own (control plane,
+ * completion callbacks, ...) have enqueues, buffer releases and management
+ * commands done on a data-plane portal without borrowing it. Each client
+ * thread gets its own single-producer/single-consumer rings; the portal owner
+ * calls qbman_proxy_service() in its loop, which batches enqueues with
+ * qbman_swp_enqueue_multiple_desc(), merges releases to the same buffer pool
+ * into commands of up to 7 buffers, and runs the management requests.
+ */
+struct qbman_proxy;
+struct qbman_proxy_client;
+
+/**
+ * struct qbman_proxy_req - A management request run on the proxied portal
+ * @fn: the function to run, e.g. a wrapper around qbman_fq_query_state().
+ * @arg: passed to @fn.
+ * @ret: the return value of @fn, valid once qbman_proxy_req_done() is true.
+ * @done: set by the portal owner once @fn has run.
+ *
+ * The request belongs to the client until @done is set. Clients poll for
+ * completion with qbman_proxy_req_done() rather than reading @done directly,
+ * so that @ret and whatever @fn wrote to @arg are not read ahead of it.
+ */
+struct qbman_proxy_req {
+	int (*fn)(struct qbman_swp *s, void *arg);
+	void *arg;
+	int ret;
+	volatile int done;
+};
+
+/**
+ * qbman_proxy_req_done() - Check whether a management request has run.
+ * @req: the request posted with qbman_proxy_call().
+ *
+ * Return non-zero once @req has run, @req->ret can then be read.
+ */
+int qbman_proxy_req_done(const struct qbman_proxy_req *req);
+
+/**
+ * qbman_proxy_create() - Create a proxy for a software portal.
+ * @s: the software portal.
+ * @max_clients: the number of clients that can be opened.
+ * @ring_size: the size of each client ring, a power of 2.
+ *
+ * Return the proxy, or NULL on failure.
+ */
+struct qbman_proxy *qbman_proxy_create(struct qbman_swp *s,
+				       uint32_t max_clients,
+				       uint32_t ring_size);
+
+/**
+ * qbman_proxy_destroy() - Free a proxy and its clients.
+ * @px: the proxy.
+ */
+void qbman_proxy_destroy(struct qbman_proxy *px);
+
+/**
+ * qbman_proxy_client_open() - Open a client.
+ * @px: the proxy.
+ *
+ * Control path, not to be called concurrently with qbman_proxy_client_open()
+ * or qbman_proxy_service().
+ *
+ * Return the client, or NULL if the proxy is full.
+ */
+struct qbman_proxy_client *qbman_proxy_client_open(struct qbman_proxy *px);
+
+/**
+ * qbman_proxy_service() - Run the pending client requests, called by the
+ * portal owner.
+ * @px: the proxy.
+ *
+ * A few management requests are run per client on each call; the rest wait
+ * for the next one.
+ *
+ * Return the number of frames, buffers and requests handled.
+ */
+int qbman_proxy_service(struct qbman_proxy *px);
+
+/**
+ * qbman_proxy_enqueue() - Post frames for enqueue.
+ * @c: the client.
+ * @d: the enqueue descriptors, one per frame.
+ * @fd: the frame descriptors.
+ * @num: the number of frames.
+ *
+ * Return the number of frames posted, less than @num if the ring is full.
+ */
+int qbman_proxy_enqueue(struct qbman_proxy_client *c,
+			const struct qbman_eq_desc *d,
+			const struct qbman_fd *fd, int num);
+
+/**
+ * qbman_proxy_release() - Post buffers for release.
+ * @c: the client.
+ * @bpid: the buffer pool.
+ * @buffers: the buffer addresses.
+ * @num: the number of buffers.
+ *
+ * Return the number of buffers posted, less than @num if the ring is full.
+ */
+int qbman_proxy_release(struct qbman_proxy_client *c, uint16_t bpid,
+			const uint64_t *buffers, int num);
+
+/**
+ * qbman_proxy_call() - Post a management request.
+ * @c: the client.
+ * @req: the request, the caller polls qbman_proxy_req_done() for completion.
+ *
+ * Return 0 for success, or -EBUSY if the ring is full.
+ */
+int qbman_proxy_call(struct qbman_proxy_client *c, struct qbman_proxy_req *req);
+
+#endif /* !_FSL_QBMAN_VPORTAL_H */